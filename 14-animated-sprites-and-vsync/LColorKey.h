@@ -0,0 +1,195 @@
+//Color key to alpha conversion
+//Turns every pixel matching the color key into a transparent one in a single
+//pass over ARGB8888 pixels, optionally premultiplying the color by alpha, so
+//textures can be uploaded as plain RGBA without SDL's color key handling.
+//The SSE2 and AVX2 kernels are picked at runtime, other CPUs use the scalar one
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LCOLORKEY_X86
+#endif
+
+class LColorKey
+{
+	public:
+		//Converts a surface to ARGB8888 with the color key as alpha, returns a new surface
+		static SDL_Surface* convertSurface( SDL_Surface* surface, Uint8 red, Uint8 green, Uint8 blue, bool premultiply = false );
+
+		//Converts count ARGB8888 pixels in place with the fastest kernel available
+		static void keyToAlpha( Uint32* pixels, size_t count, Uint32 key, bool premultiply = false );
+
+		//The individual kernels, key is a 0x00RRGGBB value
+		static void keyToAlphaScalar( Uint32* pixels, size_t count, Uint32 key, bool premultiply );
+#if defined(LCOLORKEY_X86)
+		static void keyToAlphaSSE2( Uint32* pixels, size_t count, Uint32 key, bool premultiply );
+		static void keyToAlphaAVX2( Uint32* pixels, size_t count, Uint32 key, bool premultiply );
+#endif
+};
+
+SDL_Surface* LColorKey::convertSurface( SDL_Surface* surface, Uint8 red, Uint8 green, Uint8 blue, bool premultiply )
+{
+	//Get the pixels into the kernel's format
+	SDL_Surface* converted = SDL_ConvertSurfaceFormat( surface, SDL_PIXELFORMAT_ARGB8888, 0 );
+	if( converted == NULL )
+	{
+		return NULL;
+	}
+
+	//Convert each row, pitch may be padded
+	Uint32 key = ( red << 16 ) | ( green << 8 ) | blue;
+	SDL_LockSurface( converted );
+	for( int y = 0; y < converted->h; ++y )
+	{
+		Uint32* row = (Uint32*)( (Uint8*)converted->pixels + y * converted->pitch );
+		keyToAlpha( row, converted->w, key, premultiply );
+	}
+	SDL_UnlockSurface( converted );
+
+	return converted;
+}
+
+void LColorKey::keyToAlpha( Uint32* pixels, size_t count, Uint32 key, bool premultiply )
+{
+#if defined(LCOLORKEY_X86)
+	//Check the CPU once
+	static int simd = SDL_HasAVX2() ? 2 : SDL_HasSSE2() ? 1 : 0;
+	if( simd == 2 )
+	{
+		keyToAlphaAVX2( pixels, count, key, premultiply );
+		return;
+	}
+	if( simd == 1 )
+	{
+		keyToAlphaSSE2( pixels, count, key, premultiply );
+		return;
+	}
+#endif
+	keyToAlphaScalar( pixels, count, key, premultiply );
+}
+
+void LColorKey::keyToAlphaScalar( Uint32* pixels, size_t count, Uint32 key, bool premultiply )
+{
+	for( size_t i = 0; i < count; ++i )
+	{
+		Uint32 p = pixels[ i ];
+
+		//Keyed pixels become transparent black so filtering doesn't bleed the key color
+		if( ( p & 0x00FFFFFF ) == key )
+		{
+			pixels[ i ] = 0;
+			continue;
+		}
+
+		if( premultiply )
+		{
+			//Multiply each channel by alpha with rounded division by 255
+			Uint32 a = p >> 24;
+			Uint32 r = ( ( p >> 16 ) & 0xFF ) * a + 128;
+			Uint32 g = ( ( p >> 8 ) & 0xFF ) * a + 128;
+			Uint32 b = ( p & 0xFF ) * a + 128;
+			r = ( r + ( r >> 8 ) ) >> 8;
+			g = ( g + ( g >> 8 ) ) >> 8;
+			b = ( b + ( b >> 8 ) ) >> 8;
+			pixels[ i ] = ( a << 24 ) | ( r << 16 ) | ( g << 8 ) | b;
+		}
+	}
+}
+
+#if defined(LCOLORKEY_X86)
+__attribute__(( target( "sse2" ) ))
+void LColorKey::keyToAlphaSSE2( Uint32* pixels, size_t count, Uint32 key, bool premultiply )
+{
+	const __m128i rgbMask = _mm_set1_epi32( 0x00FFFFFF );
+	const __m128i keyVector = _mm_set1_epi32( key );
+	const __m128i zero = _mm_setzero_si128();
+
+	//16 bit lanes: keep alpha for the color channels, use 255 for alpha itself
+	const __m128i colorLanes = _mm_set_epi16( 0, -1, -1, -1, 0, -1, -1, -1 );
+	const __m128i alphaLane = _mm_set_epi16( 255, 0, 0, 0, 255, 0, 0, 0 );
+	const __m128i round = _mm_set1_epi16( 128 );
+
+	size_t i = 0;
+	for( ; i + 4 <= count; i += 4 )
+	{
+		__m128i p = _mm_loadu_si128( (__m128i*)( pixels + i ) );
+
+		//Clear the pixels matching the key
+		__m128i keyed = _mm_cmpeq_epi32( _mm_and_si128( p, rgbMask ), keyVector );
+		p = _mm_andnot_si128( keyed, p );
+
+		if( premultiply )
+		{
+			//Widen to 16 bits, two pixels per half
+			__m128i lo = _mm_unpacklo_epi8( p, zero );
+			__m128i hi = _mm_unpackhi_epi8( p, zero );
+
+			//Broadcast each pixel's alpha across its channels
+			__m128i loAlpha = _mm_shufflehi_epi16( _mm_shufflelo_epi16( lo, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 3, 3, 3, 3 ) );
+			__m128i hiAlpha = _mm_shufflehi_epi16( _mm_shufflelo_epi16( hi, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 3, 3, 3, 3 ) );
+			loAlpha = _mm_or_si128( _mm_and_si128( loAlpha, colorLanes ), alphaLane );
+			hiAlpha = _mm_or_si128( _mm_and_si128( hiAlpha, colorLanes ), alphaLane );
+
+			//Multiply and divide by 255 with rounding
+			lo = _mm_add_epi16( _mm_mullo_epi16( lo, loAlpha ), round );
+			hi = _mm_add_epi16( _mm_mullo_epi16( hi, hiAlpha ), round );
+			lo = _mm_srli_epi16( _mm_add_epi16( lo, _mm_srli_epi16( lo, 8 ) ), 8 );
+			hi = _mm_srli_epi16( _mm_add_epi16( hi, _mm_srli_epi16( hi, 8 ) ), 8 );
+
+			p = _mm_packus_epi16( lo, hi );
+		}
+
+		_mm_storeu_si128( (__m128i*)( pixels + i ), p );
+	}
+
+	//Finish the last few pixels
+	keyToAlphaScalar( pixels + i, count - i, key, premultiply );
+}
+
+__attribute__(( target( "avx2" ) ))
+void LColorKey::keyToAlphaAVX2( Uint32* pixels, size_t count, Uint32 key, bool premultiply )
+{
+	const __m256i rgbMask = _mm256_set1_epi32( 0x00FFFFFF );
+	const __m256i keyVector = _mm256_set1_epi32( key );
+	const __m256i zero = _mm256_setzero_si256();
+
+	//16 bit lanes: keep alpha for the color channels, use 255 for alpha itself
+	const __m256i colorLanes = _mm256_set_epi16( 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1 );
+	const __m256i alphaLane = _mm256_set_epi16( 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0 );
+	const __m256i round = _mm256_set1_epi16( 128 );
+
+	size_t i = 0;
+	for( ; i + 8 <= count; i += 8 )
+	{
+		__m256i p = _mm256_loadu_si256( (__m256i*)( pixels + i ) );
+
+		//Clear the pixels matching the key
+		__m256i keyed = _mm256_cmpeq_epi32( _mm256_and_si256( p, rgbMask ), keyVector );
+		p = _mm256_andnot_si256( keyed, p );
+
+		if( premultiply )
+		{
+			//Widen to 16 bits, unpacking and packing both work within 128 bit halves so the order holds
+			__m256i lo = _mm256_unpacklo_epi8( p, zero );
+			__m256i hi = _mm256_unpackhi_epi8( p, zero );
+
+			//Broadcast each pixel's alpha across its channels
+			__m256i loAlpha = _mm256_shufflehi_epi16( _mm256_shufflelo_epi16( lo, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 3, 3, 3, 3 ) );
+			__m256i hiAlpha = _mm256_shufflehi_epi16( _mm256_shufflelo_epi16( hi, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 3, 3, 3, 3 ) );
+			loAlpha = _mm256_or_si256( _mm256_and_si256( loAlpha, colorLanes ), alphaLane );
+			hiAlpha = _mm256_or_si256( _mm256_and_si256( hiAlpha, colorLanes ), alphaLane );
+
+			//Multiply and divide by 255 with rounding
+			lo = _mm256_add_epi16( _mm256_mullo_epi16( lo, loAlpha ), round );
+			hi = _mm256_add_epi16( _mm256_mullo_epi16( hi, hiAlpha ), round );
+			lo = _mm256_srli_epi16( _mm256_add_epi16( lo, _mm256_srli_epi16( lo, 8 ) ), 8 );
+			hi = _mm256_srli_epi16( _mm256_add_epi16( hi, _mm256_srli_epi16( hi, 8 ) ), 8 );
+
+			p = _mm256_packus_epi16( lo, hi );
+		}
+
+		_mm256_storeu_si256( (__m256i*)( pixels + i ), p );
+	}
+
+	//Finish the last few pixels
+	keyToAlphaScalar( pixels + i, count - i, key, premultiply );
+}
+#endif
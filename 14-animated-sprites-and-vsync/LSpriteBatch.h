@@ -0,0 +1,173 @@
+//Sprite batch renderer
+//Queues textured quads and draws each run of sprites sharing a texture and
+//blend mode with a single SDL_RenderGeometry call
+class LSpriteBatch
+{
+	public:
+		//Initializes variables
+		LSpriteBatch();
+
+		//Queues a sprite using the same parameters as SDL_RenderCopyEx, the color
+		//is applied per vertex in place of the texture's color and alpha modulation
+		void draw( SDL_Texture* texture, int texWidth, int texHeight, SDL_Rect* clip, SDL_Rect* dest, double angle = 0.0, SDL_Point* center = NULL, SDL_RendererFlip flip = SDL_FLIP_NONE, SDL_Color color = WHITE );
+
+		//Queues a whole texture or a clip of it at given point
+		void draw( LTexture* texture, int x, int y, SDL_Rect* clip = NULL, double angle = 0.0, SDL_Point* center = NULL, SDL_RendererFlip flip = SDL_FLIP_NONE, SDL_Color color = WHITE );
+
+		//Renders all queued sprites and empties the queue
+		void flush( SDL_Renderer* renderer );
+
+		//Gets the number of geometry calls made by the last flush
+		int getDrawCalls();
+
+	private:
+		//Unmodulated sprite color
+		static const SDL_Color WHITE;
+
+		//Consecutive sprites drawn with one call
+		struct Run
+		{
+			SDL_Texture* texture;
+			SDL_BlendMode blending;
+			int firstVertex;
+			int quadCount;
+		};
+
+		//Queued geometry, the buffers keep their capacity between frames
+		std::vector<SDL_Vertex> mVertices;
+		std::vector<Run> mRuns;
+
+		//Shared quad index pattern
+		std::vector<int> mIndices;
+
+		//Geometry calls made by the last flush
+		int mDrawCalls;
+};
+
+const SDL_Color LSpriteBatch::WHITE = { 0xFF, 0xFF, 0xFF, 0xFF };
+
+LSpriteBatch::LSpriteBatch()
+{
+	//Initialize
+	mDrawCalls = 0;
+}
+
+void LSpriteBatch::draw( SDL_Texture* texture, int texWidth, int texHeight, SDL_Rect* clip, SDL_Rect* dest, double angle, SDL_Point* center, SDL_RendererFlip flip, SDL_Color color )
+{
+	if( texture == NULL || texWidth <= 0 || texHeight <= 0 )
+	{
+		return;
+	}
+
+	//Source rectangle in texture coordinates
+	SDL_Rect src = { 0, 0, texWidth, texHeight };
+	if( clip != NULL )
+	{
+		src = *clip;
+	}
+
+	float u0 = (float)src.x / texWidth;
+	float v0 = (float)src.y / texHeight;
+	float u1 = (float)( src.x + src.w ) / texWidth;
+	float v1 = (float)( src.y + src.h ) / texHeight;
+
+	//Flipping swaps the texture coordinates
+	if( flip & SDL_FLIP_HORIZONTAL )
+	{
+		float t = u0; u0 = u1; u1 = t;
+	}
+	if( flip & SDL_FLIP_VERTICAL )
+	{
+		float t = v0; v0 = v1; v1 = t;
+	}
+
+	//Corners relative to the rotation center, which defaults to the middle of the destination
+	float cx = center != NULL ? center->x : dest->w / 2.f;
+	float cy = center != NULL ? center->y : dest->h / 2.f;
+	float xs[ 4 ] = { -cx, dest->w - cx, dest->w - cx, -cx };
+	float ys[ 4 ] = { -cy, -cy, dest->h - cy, dest->h - cy };
+	float us[ 4 ] = { u0, u1, u1, u0 };
+	float vs[ 4 ] = { v0, v0, v1, v1 };
+
+	//Clockwise rotation like SDL_RenderCopyEx
+	float c = 1.f;
+	float s = 0.f;
+	if( angle != 0.0 )
+	{
+		double radians = angle * M_PI / 180.0;
+		c = cos( radians );
+		s = sin( radians );
+	}
+
+	//Start a new run when the texture or blend mode changes
+	SDL_BlendMode blending = SDL_BLENDMODE_NONE;
+	SDL_GetTextureBlendMode( texture, &blending );
+	if( mRuns.empty() || mRuns.back().texture != texture || mRuns.back().blending != blending )
+	{
+		Run run = { texture, blending, (int)mVertices.size(), 0 };
+		mRuns.push_back( run );
+	}
+	++mRuns.back().quadCount;
+
+	//Queue the corners
+	for( int i = 0; i < 4; ++i )
+	{
+		SDL_Vertex v;
+		v.position.x = dest->x + cx + xs[ i ] * c - ys[ i ] * s;
+		v.position.y = dest->y + cy + xs[ i ] * s + ys[ i ] * c;
+		v.color = color;
+		v.tex_coord.x = us[ i ];
+		v.tex_coord.y = vs[ i ];
+		mVertices.push_back( v );
+	}
+}
+
+void LSpriteBatch::draw( LTexture* texture, int x, int y, SDL_Rect* clip, double angle, SDL_Point* center, SDL_RendererFlip flip, SDL_Color color )
+{
+	//Set rendering space
+	SDL_Rect renderQuad = { x, y, texture->getWidth(), texture->getHeight() };
+
+	//Set clip rendering dimensions
+	if( clip != NULL )
+	{
+		renderQuad.w = clip->w;
+		renderQuad.h = clip->h;
+	}
+
+	draw( texture->getTexture(), texture->getWidth(), texture->getHeight(), clip, &renderQuad, angle, center, flip, color );
+}
+
+void LSpriteBatch::flush( SDL_Renderer* renderer )
+{
+	mDrawCalls = 0;
+
+	for( int r = 0; r < mRuns.size(); ++r )
+	{
+		Run& run = mRuns[ r ];
+
+		//Grow the shared index pattern to cover the run
+		for( int q = mIndices.size() / 6; q < run.quadCount; ++q )
+		{
+			mIndices.push_back( q * 4 );
+			mIndices.push_back( q * 4 + 1 );
+			mIndices.push_back( q * 4 + 2 );
+			mIndices.push_back( q * 4 );
+			mIndices.push_back( q * 4 + 2 );
+			mIndices.push_back( q * 4 + 3 );
+		}
+
+		//Render the run
+		SDL_SetTextureBlendMode( run.texture, run.blending );
+		SDL_RenderGeometry( renderer, run.texture, &mVertices[ run.firstVertex ], run.quadCount * 4, &mIndices[ 0 ], run.quadCount * 6 );
+		++mDrawCalls;
+	}
+
+	//Empty the queue
+	mVertices.clear();
+	mRuns.clear();
+}
+
+int LSpriteBatch::getDrawCalls()
+{
+	return mDrawCalls;
+}
@@ -30,7 +30,30 @@ class LTexture
 		int getWidth();
 		int getHeight();
 
+		//Gets the hardware texture
+		SDL_Texture* getTexture();
+
 	private:
+		//Pixel cache file identification
+		static const Uint32 PIXEL_CACHE_MAGIC = 0x4358504C;
+		static const Uint32 PIXEL_CACHE_VERSION = 2;
+
+		//Bytes before the pixels and where the source modification time is in them
+		static const int PIXEL_CACHE_HEADER_SIZE = 48;
+		static const int PIXEL_CACHE_TIME_OFFSET = 24;
+
+		//Format of the cached pixels, native to most SDL renderers
+		static const Uint32 PIXEL_CACHE_FORMAT = SDL_PIXELFORMAT_ARGB8888;
+
+		//Uploads the pre-converted pixels cached next to the image, if still valid
+		bool loadFromPixelCache( SDL_Renderer* renderer, std::string path );
+
+		//Saves the color keyed image's pixels, already in the cache format, next to it for the next load
+		void savePixelCache( std::string path, SDL_Surface* surface );
+
+		//Hashes the image file the cache was made from
+		static Uint64 hashFile( std::string path );
+
 		//The actual hardware texture
 		SDL_Texture* mTexture;
 		SDL_Renderer* mRenderer;
@@ -63,6 +86,12 @@ bool LTexture::loadFromFile( SDL_Renderer* renderer, std::string path )
 	//Set renderer for process
 	mRenderer = renderer;
 
+	//Skip decoding when the converted pixels are cached
+	if( loadFromPixelCache( renderer, path ) )
+	{
+		return true;
+	}
+
 	//The final texture
 	SDL_Texture* newTexture = NULL;
 
@@ -74,20 +103,31 @@ bool LTexture::loadFromFile( SDL_Renderer* renderer, std::string path )
 	}
 	else
 	{
-		//Color key image
-		SDL_SetColorKey( loadedSurface, SDL_TRUE, SDL_MapRGB( loadedSurface->format, 0, 0xFF, 0xFF ) );
-
-		//Create texture from surface pixels
-		newTexture = SDL_CreateTextureFromSurface( mRenderer, loadedSurface );
-		if( newTexture == NULL )
+		//Color key image into real alpha
+		SDL_Surface* keyedSurface = LColorKey::convertSurface( loadedSurface, 0, 0xFF, 0xFF );
+		if( keyedSurface == NULL )
 		{
-			printf( "unable to create texture from %s! SDL Error: %s\n", path.c_str(), SDL_GetError() );
+			printf( "Unable to convert image %s! SDL Error: %s\n", path.c_str(), SDL_GetError() );
 		}
 		else
 		{
-			//Get image dimensions
-			mWidth = loadedSurface->w;
-			mHeight = loadedSurface->h;
+			//Create texture from surface pixels
+			newTexture = SDL_CreateTextureFromSurface( mRenderer, keyedSurface );
+			if( newTexture == NULL )
+			{
+				printf( "unable to create texture from %s! SDL Error: %s\n", path.c_str(), SDL_GetError() );
+			}
+			else
+			{
+				//Get image dimensions
+				mWidth = keyedSurface->w;
+				mHeight = keyedSurface->h;
+
+				//Cache the converted pixels for the next load
+				savePixelCache( path, keyedSurface );
+			}
+
+			SDL_FreeSurface( keyedSurface );
 		}
 
 		//Get rid of old loaded surface
@@ -99,6 +139,146 @@ bool LTexture::loadFromFile( SDL_Renderer* renderer, std::string path )
 	return mTexture != NULL;
 }
 
+bool LTexture::loadFromPixelCache( SDL_Renderer* renderer, std::string path )
+{
+	//The cache is only valid next to its image
+	struct stat source;
+	if( stat( path.c_str(), &source ) != 0 )
+	{
+		return false;
+	}
+
+	std::string cachePath = path + ".pxc";
+	SDL_RWops* file = SDL_RWFromFile( cachePath.c_str(), "rb" );
+	if( file == NULL )
+	{
+		return false;
+	}
+
+	//Read the header
+	Uint32 magic = SDL_ReadLE32( file );
+	Uint32 version = SDL_ReadLE32( file );
+	Uint32 format = SDL_ReadLE32( file );
+	int width = SDL_ReadLE32( file );
+	int height = SDL_ReadLE32( file );
+	int pitch = SDL_ReadLE32( file );
+	Uint64 sourceTime = SDL_ReadLE64( file );
+	Uint64 sourceSize = SDL_ReadLE64( file );
+	Uint64 sourceHash = SDL_ReadLE64( file );
+
+	bool valid = magic == PIXEL_CACHE_MAGIC && version == PIXEL_CACHE_VERSION && format == PIXEL_CACHE_FORMAT &&
+		width > 0 && height > 0 && pitch >= width * 4 && sourceSize == (Uint64)source.st_size;
+
+	//The pixels have to fill the rest of the file exactly, a corrupt header mustn't size the buffer
+	if( valid && SDL_RWsize( file ) != PIXEL_CACHE_HEADER_SIZE + (Sint64)pitch * height )
+	{
+		valid = false;
+	}
+
+	//A new modification time alone, as after a checkout, is fine if the contents still match
+	if( valid && sourceTime != (Uint64)source.st_mtime )
+	{
+		valid = hashFile( path ) == sourceHash;
+		if( valid )
+		{
+			//Remember the new time so the next load skips the hash, a read only cache just hashes again
+			SDL_RWops* update = SDL_RWFromFile( cachePath.c_str(), "r+b" );
+			if( update != NULL )
+			{
+				SDL_RWseek( update, PIXEL_CACHE_TIME_OFFSET, RW_SEEK_SET );
+				SDL_WriteLE64( update, source.st_mtime );
+				SDL_RWclose( update );
+			}
+		}
+	}
+
+	//Upload the pixels as they are
+	SDL_Texture* newTexture = NULL;
+	if( valid )
+	{
+		std::vector<Uint8> pixels( (size_t)pitch * height );
+		if( SDL_RWread( file, &pixels[ 0 ], pitch, height ) == (size_t)height )
+		{
+			newTexture = SDL_CreateTexture( renderer, PIXEL_CACHE_FORMAT, SDL_TEXTUREACCESS_STATIC, width, height );
+			if( newTexture != NULL && SDL_UpdateTexture( newTexture, NULL, &pixels[ 0 ], pitch ) < 0 )
+			{
+				SDL_DestroyTexture( newTexture );
+				newTexture = NULL;
+			}
+		}
+	}
+
+	SDL_RWclose( file );
+
+	if( newTexture == NULL )
+	{
+		return false;
+	}
+
+	//The color key is already alpha
+	SDL_SetTextureBlendMode( newTexture, SDL_BLENDMODE_BLEND );
+
+	mTexture = newTexture;
+	mWidth = width;
+	mHeight = height;
+	return true;
+}
+
+void LTexture::savePixelCache( std::string path, SDL_Surface* surface )
+{
+	struct stat source;
+	if( stat( path.c_str(), &source ) != 0 )
+	{
+		return;
+	}
+
+	std::string cachePath = path + ".pxc";
+	SDL_RWops* file = SDL_RWFromFile( cachePath.c_str(), "wb" );
+	if( file == NULL )
+	{
+		printf( "Unable to write pixel cache %s! SDL Error: %s\n", cachePath.c_str(), SDL_GetError() );
+	}
+	else
+	{
+		//Write the header
+		SDL_WriteLE32( file, PIXEL_CACHE_MAGIC );
+		SDL_WriteLE32( file, PIXEL_CACHE_VERSION );
+		SDL_WriteLE32( file, PIXEL_CACHE_FORMAT );
+		SDL_WriteLE32( file, surface->w );
+		SDL_WriteLE32( file, surface->h );
+		SDL_WriteLE32( file, surface->pitch );
+		SDL_WriteLE64( file, source.st_mtime );
+		SDL_WriteLE64( file, source.st_size );
+		SDL_WriteLE64( file, hashFile( path ) );
+
+		//Write the pixels
+		SDL_LockSurface( surface );
+		SDL_RWwrite( file, surface->pixels, surface->pitch, surface->h );
+		SDL_UnlockSurface( surface );
+
+		SDL_RWclose( file );
+	}
+}
+
+Uint64 LTexture::hashFile( std::string path )
+{
+	//FNV-1a over the file contents
+	Uint64 hash = 14695981039346656037ULL;
+
+	size_t size;
+	Uint8* data = (Uint8*)SDL_LoadFile( path.c_str(), &size );
+	if( data != NULL )
+	{
+		for( size_t i = 0; i < size; ++i )
+		{
+			hash = ( hash ^ data[ i ] ) * 1099511628211ULL;
+		}
+		SDL_free( data );
+	}
+
+	return hash;
+}
+
 void LTexture::free()
 {
 	//Free texture if it exists
@@ -155,3 +335,8 @@ int LTexture::getHeight()
 {
 	return mHeight;
 }
+
+SDL_Texture* LTexture::getTexture()
+{
+	return mTexture;
+}
@@ -1,8 +1,17 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <sys/stat.h>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include "LColorKey.h"
 #include "LTexture.h"
+#include "LSpriteBatch.h"
+#include "LInputLog.h"
+#include "LBenchmark.h"
 
 //Screen dimension constants
 const int SCREEN_WIDTH = 640;
@@ -31,6 +40,19 @@ SDL_Rect gSpriteClips[ WALKING_ANIMATION_FRAMES ];
 LTexture gSpriteSheetTexture;
 LTexture gBackgroundTexture;
 
+//Headless benchmark mode
+LBenchmark gBenchmark;
+
+//Batches the walker draws into geometry calls
+LSpriteBatch gSpriteBatch;
+
+//A walker on the screen
+struct Walker
+{
+	int x, y;
+	int frameOffset;
+};
+
 bool init()
 {
 	//Initialization flag
@@ -152,6 +174,9 @@ void close()
 
 int main( int argc, char* args[] )
 {
+	//Run headless if the benchmark runner started us
+	gBenchmark.configure( "animated" );
+
 	//Start up SDL and create window
 	if( !init() )
 	{
@@ -175,18 +200,47 @@ int main( int argc, char* args[] )
 			//Current animation frame
 			int frame = 0;
 
+			//Number of walkers comes from the command line for stress testing
+			int walkerCount = 1;
+			if( argc > 1 )
+			{
+				walkerCount = atoi( args[ 1 ] );
+				if( walkerCount < 1 )
+					walkerCount = 1;
+			}
+
+			//A single walker stands in the middle, a crowd is scattered across the screen
+			std::vector<Walker> walkers( walkerCount );
+			walkers[ 0 ].x = ( SCREEN_WIDTH - gSpriteClips[ 0 ].w ) / 2;
+			walkers[ 0 ].y = ( SCREEN_HEIGHT - gSpriteClips[ 0 ].h ) / 2;
+			walkers[ 0 ].frameOffset = 0;
+			for( int i = 1; i < walkerCount; ++i )
+			{
+				walkers[ i ].x = rand() % ( SCREEN_WIDTH - gSpriteClips[ 0 ].w );
+				walkers[ i ].y = rand() % ( SCREEN_HEIGHT - gSpriteClips[ 0 ].h );
+				walkers[ i ].frameOffset = rand() % ( WALKING_ANIMATION_FRAMES * 4 );
+			}
+
 			//Modulation components
 			Uint8 r = 255;
 			Uint8 g = 255;
 			Uint8 b = 255;
 			Uint8 a = 255;
 
+			gBenchmark.markLoaded();
+
 			//While application is running
 			while( !quit )
 			{
+				//Feed scripted input when benchmarking
+				gBenchmark.beginFrame();
+
 				//Handle events on queue
 				while( SDL_PollEvent( &e ) != 0 )
 				{
+					//Keep it for replay if recording
+					gBenchmark.recordEvent( e );
+
 					//User requests quit
 					if( e.type == SDL_QUIT )
 					{
@@ -257,15 +311,21 @@ int main( int argc, char* args[] )
 				//Render background
 				gBackgroundTexture.render( 0, 0 );
 
-				//Modulate and render texture
-				gSpriteSheetTexture.setColor( r, g, b );
-				gSpriteSheetTexture.setAlpha( a );
+				//Queue the walkers with their modulation as vertex color
+				SDL_Color modulation = { r, g, b, a };
+				for( int i = 0; i < walkerCount; ++i )
+				{
+					int walkerFrame = ( frame + walkers[ i ].frameOffset ) % ( WALKING_ANIMATION_FRAMES * 4 );
+					SDL_Rect* currentClip = &gSpriteClips[ walkerFrame / 4 ];
+					gSpriteBatch.draw( &gSpriteSheetTexture, walkers[ i ].x, walkers[ i ].y, currentClip, 0.0, NULL, SDL_FLIP_NONE, modulation );
+				}
 
-				SDL_Rect* currentClip = &gSpriteClips[ frame / 4 ];
-				gSpriteSheetTexture.render( ( SCREEN_WIDTH - currentClip->w ) / 2 , ( SCREEN_HEIGHT - currentClip->h ) / 2 , currentClip );
+				//Render texture
+				gSpriteBatch.flush( gRenderer );
 
 				//Update screen
 				SDL_RenderPresent( gRenderer );
+				gBenchmark.endFrame();
 
 				//Go to next frame
 				++frame;
@@ -276,6 +336,8 @@ int main( int argc, char* args[] )
 					frame = 0;
 				}
 			}
+
+			gBenchmark.report();
 		}
 	}
 
@@ -0,0 +1,212 @@
+//Benchmarks color key to alpha conversion against SDL's color key path
+//usage: colorkeybench [image] [size] [runs]
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "LColorKey.h"
+
+//A kernel under test
+typedef void (*KeyKernel)( Uint32* pixels, size_t count, Uint32 key, bool premultiply );
+
+//Cyan color key used by the lessons
+const Uint32 COLOR_KEY = 0x0000FFFF;
+
+//Gets elapsed milliseconds between two performance counter readings
+double elapsedMs( Uint64 start, Uint64 end )
+{
+	return (double)( end - start ) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+//Prints a result line
+void report( const char* name, double ms, size_t pixels )
+{
+	printf( "%-28s %9.3f ms %9.1f MPix/s\n", name, ms, pixels / ( ms * 1000.0 ) );
+}
+
+//Tiles an image into a size x size surface of the same format
+SDL_Surface* tileImage( SDL_Surface* image, int size )
+{
+	SDL_Surface* sheet = SDL_CreateRGBSurfaceWithFormat( 0, size, size, image->format->BitsPerPixel, image->format->format );
+	if( sheet == NULL )
+	{
+		return NULL;
+	}
+
+	//Copy the image as is, no blending
+	SDL_SetSurfaceBlendMode( image, SDL_BLENDMODE_NONE );
+	for( int y = 0; y < size; y += image->h )
+	{
+		for( int x = 0; x < size; x += image->w )
+		{
+			SDL_Rect dest = { x, y, image->w, image->h };
+			SDL_BlitSurface( image, NULL, sheet, &dest );
+		}
+	}
+
+	return sheet;
+}
+
+//Makes a sprite sheet like test image when no image is available
+SDL_Surface* makeSheet( int size )
+{
+	SDL_Surface* sheet = SDL_CreateRGBSurfaceWithFormat( 0, size, size, 32, SDL_PIXELFORMAT_ARGB8888 );
+	if( sheet == NULL )
+	{
+		return NULL;
+	}
+
+	//Opaque noise sprites on a cyan background, roughly half keyed
+	srand( 1 );
+	for( int y = 0; y < size; ++y )
+	{
+		Uint32* row = (Uint32*)( (Uint8*)sheet->pixels + y * sheet->pitch );
+		for( int x = 0; x < size; ++x )
+		{
+			bool sprite = ( ( x / 64 ) + ( y / 64 ) ) % 2 == 0;
+			row[ x ] = sprite ? 0xFF000000 | ( rand() & 0xFFFFFF ) : 0xFF000000 | COLOR_KEY;
+		}
+	}
+
+	return sheet;
+}
+
+//Times a kernel over fresh copies of the source pixels, returning the best run
+double timeKernel( KeyKernel kernel, const std::vector<Uint32>& source, std::vector<Uint32>& output, bool premultiply, int runs )
+{
+	double best = 0;
+	for( int i = 0; i < runs; ++i )
+	{
+		output = source;
+		Uint64 start = SDL_GetPerformanceCounter();
+		kernel( &output[ 0 ], output.size(), COLOR_KEY, premultiply );
+		double ms = elapsedMs( start, SDL_GetPerformanceCounter() );
+		if( i == 0 || ms < best )
+		{
+			best = ms;
+		}
+	}
+	return best;
+}
+
+int main( int argc, char* args[] )
+{
+	const char* path = argc > 1 ? args[ 1 ] : "textures/spritesheet.png";
+	int size = argc > 2 ? atoi( args[ 2 ] ) : 4096;
+	int runs = argc > 3 ? atoi( args[ 3 ] ) : 10;
+	if( size <= 0 || runs <= 0 )
+	{
+		printf( "usage: %s [image] [size] [runs]\n", args[ 0 ] );
+		return 1;
+	}
+
+	if( SDL_Init( 0 ) < 0 || !( IMG_Init( IMG_INIT_PNG ) & IMG_INIT_PNG ) )
+	{
+		printf( "Unable to initialize SDL! SDL Error: %s\n", SDL_GetError() );
+		return 1;
+	}
+
+	//Build the test sheet
+	SDL_Surface* sheet = NULL;
+	SDL_Surface* image = IMG_Load( path );
+	if( image != NULL )
+	{
+		sheet = tileImage( image, size );
+		SDL_FreeSurface( image );
+	}
+	else
+	{
+		printf( "Unable to load %s, using a generated sheet\n", path );
+		sheet = makeSheet( size );
+	}
+	if( sheet == NULL )
+	{
+		printf( "Unable to create sheet! SDL Error: %s\n", SDL_GetError() );
+		return 1;
+	}
+
+	size_t pixels = (size_t)sheet->w * sheet->h;
+	printf( "%dx%d %s, best of %d runs\n", sheet->w, sheet->h, SDL_GetPixelFormatName( sheet->format->format ), runs );
+
+	//SDL's path: color key then convert to a format with alpha
+	double sdlMs = 0;
+	for( int i = 0; i < runs; ++i )
+	{
+		Uint64 start = SDL_GetPerformanceCounter();
+		SDL_SetColorKey( sheet, SDL_TRUE, SDL_MapRGB( sheet->format, 0, 0xFF, 0xFF ) );
+		SDL_Surface* converted = SDL_ConvertSurfaceFormat( sheet, SDL_PIXELFORMAT_ARGB8888, 0 );
+		double ms = elapsedMs( start, SDL_GetPerformanceCounter() );
+		SDL_SetColorKey( sheet, SDL_FALSE, 0 );
+		SDL_FreeSurface( converted );
+		if( i == 0 || ms < sdlMs )
+		{
+			sdlMs = ms;
+		}
+	}
+	report( "SDL color key + convert", sdlMs, pixels );
+
+	//The whole LColorKey path, format conversion included
+	double convertMs = 0;
+	for( int i = 0; i < runs; ++i )
+	{
+		Uint64 start = SDL_GetPerformanceCounter();
+		SDL_Surface* converted = LColorKey::convertSurface( sheet, 0, 0xFF, 0xFF );
+		double ms = elapsedMs( start, SDL_GetPerformanceCounter() );
+		SDL_FreeSurface( converted );
+		if( i == 0 || ms < convertMs )
+		{
+			convertMs = ms;
+		}
+	}
+	report( "LColorKey convert", convertMs, pixels );
+
+	//Unkeyed ARGB8888 pixels for the kernels alone
+	SDL_Surface* argb = SDL_ConvertSurfaceFormat( sheet, SDL_PIXELFORMAT_ARGB8888, 0 );
+	std::vector<Uint32> source( pixels );
+	for( int y = 0; y < argb->h; ++y )
+	{
+		memcpy( &source[ y * argb->w ], (Uint8*)argb->pixels + y * argb->pitch, argb->w * 4 );
+	}
+	SDL_FreeSurface( argb );
+
+	//Time each kernel and check it against the scalar one
+	bool success = true;
+	for( int premultiply = 0; premultiply < 2; ++premultiply )
+	{
+		std::vector<Uint32> expected, output;
+		double ms = timeKernel( LColorKey::keyToAlphaScalar, source, expected, premultiply, runs );
+		report( premultiply ? "scalar premultiplied" : "scalar", ms, pixels );
+
+#if defined(LCOLORKEY_X86)
+		if( SDL_HasSSE2() )
+		{
+			ms = timeKernel( LColorKey::keyToAlphaSSE2, source, output, premultiply, runs );
+			report( premultiply ? "sse2 premultiplied" : "sse2", ms, pixels );
+			if( output != expected )
+			{
+				printf( "SSE2 output differs from scalar!\n" );
+				success = false;
+			}
+		}
+
+		if( SDL_HasAVX2() )
+		{
+			ms = timeKernel( LColorKey::keyToAlphaAVX2, source, output, premultiply, runs );
+			report( premultiply ? "avx2 premultiplied" : "avx2", ms, pixels );
+			if( output != expected )
+			{
+				printf( "AVX2 output differs from scalar!\n" );
+				success = false;
+			}
+		}
+#endif
+	}
+
+	SDL_FreeSurface( sheet );
+	IMG_Quit();
+	SDL_Quit();
+
+	return success ? 0 : 1;
+}
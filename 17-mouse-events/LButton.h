@@ -23,6 +23,18 @@ class LButton
 		//Sets top left position
 		void setPosition( int x, int y );
 
+		//Sets size, the sprite is stretched to fit
+		void setSize( int width, int height );
+
+		//Gets the area the button covers
+		SDL_Rect getBox();
+
+		//Checks whether a point is on the button
+		bool contains( int x, int y );
+
+		//Shows a sprite until the next change
+		void setSprite( LButtonSprite sprite );
+
 		//Handles mouse event
 		void handleEvent( SDL_Event* e );
 
@@ -32,6 +44,10 @@ class LButton
 	private:
 		//Top left position
 		SDL_Point mPosition;
+
+		//Button dimensions
+		int mWidth;
+		int mHeight;
 		
 		//Currently used global sprite
 		LButtonSprite mCurrentSprite;
@@ -45,6 +61,8 @@ LButton::LButton()
 {
 	mPosition.x = 0;
 	mPosition.y = 0;
+	mWidth = BUTTON_WIDTH;
+	mHeight = BUTTON_HEIGHT;
 
 	mCurrentSprite = BUTTON_SPRITE_MOUSE_OUT;
 
@@ -63,41 +81,49 @@ void LButton::setPosition( int x, int y )
 	mPosition.y = y;
 }
 
+void LButton::setSize( int width, int height )
+{
+	mWidth = width;
+	mHeight = height;
+}
+
+SDL_Rect LButton::getBox()
+{
+	SDL_Rect box = { mPosition.x, mPosition.y, mWidth, mHeight };
+	return box;
+}
+
+bool LButton::contains( int x, int y )
+{
+	//Right and bottom edges belong to the next button over
+	return x >= mPosition.x && x < mPosition.x + mWidth && y >= mPosition.y && y < mPosition.y + mHeight;
+}
+
+void LButton::setSprite( LButtonSprite sprite )
+{
+	mCurrentSprite = sprite;
+}
+
 void LButton::handleEvent( SDL_Event* e )
 {
 	//If mouse event happened
 	if( e->type == SDL_MOUSEMOTION || e->type == SDL_MOUSEBUTTONDOWN || e->type == SDL_MOUSEBUTTONUP )
 	{
-		//Get mouse position
+		//Get mouse position where the event happened, the current mouse state may have moved on
 		int x, y;
-		SDL_GetMouseState( &x, &y );
-
-		//Check if mouse is in button
-		bool inside = true;
-
-		//Mouse is left of the button
-		if( x < mPosition.x )
-		{
-			inside = false;
-		}
-		//Mouse is right of the button
-		else if( x > mPosition.x + BUTTON_WIDTH )
+		if( e->type == SDL_MOUSEMOTION )
 		{
-			inside = false;
+			x = e->motion.x;
+			y = e->motion.y;
 		}
-		//Mouse is above the button
-		else if( y < mPosition.y )
-		{
-			inside = false;
-		}
-		//Mouse is below the button
-		else if( y > mPosition.y + BUTTON_HEIGHT )
+		else
 		{
-			inside = false;
+			x = e->button.x;
+			y = e->button.y;
 		}
 
 		//Mouse is outside button
-		if( !inside )
+		if( !contains( x, y ) )
 		{
 			mCurrentSprite = BUTTON_SPRITE_MOUSE_OUT;
 		}
@@ -125,5 +151,6 @@ void LButton::handleEvent( SDL_Event* e )
 void LButton::render( SDL_Renderer* renderer, LTexture* texture )
 {
 	//Show current button sprite
-	texture->render( renderer, mPosition.x, mPosition.y, &mSpriteClips[ mCurrentSprite ] );
+	SDL_Rect box = getBox();
+	texture->renderScaled( renderer, box, &mSpriteClips[ mCurrentSprite ] );
 }
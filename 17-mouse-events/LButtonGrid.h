@@ -0,0 +1,167 @@
+//Mouse hit-test grid over buttons
+//Each button is listed in every cell of a uniform grid its box touches, so
+//finding the button under the mouse only looks through one cell's short
+//list instead of every button. The grid remembers which button the mouse is
+//over, so a mouse event only changes that button and the one the mouse left.
+//Where boxes overlap the button added last is on top, as it's drawn last
+class LButtonGrid
+{
+	public:
+		//Initializes variables for buttons inside width by height
+		LButtonGrid( int width, int height, int cellSize = 64 );
+
+		//Lists a button by its current box, it must not move or go away while listed
+		void add( LButton* button );
+
+		//Removes every button
+		void clear();
+
+		//Finds the topmost button at a point, NULL if there is none
+		LButton* hitTest( int x, int y );
+
+		//Handles mouse event for the buttons it concerns
+		void handleEvent( SDL_Event* e );
+
+		//Gets the number of buttons
+		int getCount();
+
+	private:
+		//Finds the index of the topmost button at a point, -1 if there is none
+		int find( int x, int y );
+
+		//Grid dimensions in cells and the size of a cell
+		int mColumns;
+		int mRows;
+		int mCellSize;
+
+		//Indices of the buttons touching each cell, row by row, in the order they were added
+		std::vector< std::vector<int> > mCells;
+
+		//The buttons
+		std::vector<LButton*> mButtons;
+
+		//The button the mouse was last over, -1 for none
+		int mHovered;
+};
+
+LButtonGrid::LButtonGrid( int width, int height, int cellSize )
+{
+	//Initialize
+	mCellSize = cellSize > 0 ? cellSize : 64;
+	mColumns = SDL_max( ( width + mCellSize - 1 ) / mCellSize, 1 );
+	mRows = SDL_max( ( height + mCellSize - 1 ) / mCellSize, 1 );
+	mCells.resize( mColumns * mRows );
+	mHovered = -1;
+}
+
+void LButtonGrid::add( LButton* button )
+{
+	int index = mButtons.size();
+	mButtons.push_back( button );
+
+	//List the button in the cells its box touches, parts off the grid can't be hit
+	SDL_Rect box = button->getBox();
+	if( box.w <= 0 || box.h <= 0 )
+	{
+		return;
+	}
+
+	int x0 = SDL_max( box.x / mCellSize, 0 );
+	int y0 = SDL_max( box.y / mCellSize, 0 );
+	int x1 = SDL_min( ( box.x + box.w - 1 ) / mCellSize, mColumns - 1 );
+	int y1 = SDL_min( ( box.y + box.h - 1 ) / mCellSize, mRows - 1 );
+	for( int cy = y0; cy <= y1; ++cy )
+	{
+		for( int cx = x0; cx <= x1; ++cx )
+		{
+			mCells[ cy * mColumns + cx ].push_back( index );
+		}
+	}
+}
+
+void LButtonGrid::clear()
+{
+	for( int i = 0; i < mCells.size(); ++i )
+	{
+		mCells[ i ].clear();
+	}
+	mButtons.clear();
+	mHovered = -1;
+}
+
+LButton* LButtonGrid::hitTest( int x, int y )
+{
+	int index = find( x, y );
+	return index >= 0 ? mButtons[ index ] : NULL;
+}
+
+void LButtonGrid::handleEvent( SDL_Event* e )
+{
+	//If mouse event happened
+	if( e->type != SDL_MOUSEMOTION && e->type != SDL_MOUSEBUTTONDOWN && e->type != SDL_MOUSEBUTTONUP )
+	{
+		return;
+	}
+
+	//Get mouse position where the event happened
+	int hit;
+	if( e->type == SDL_MOUSEMOTION )
+	{
+		hit = find( e->motion.x, e->motion.y );
+	}
+	else
+	{
+		hit = find( e->button.x, e->button.y );
+	}
+
+	//The button the mouse left goes back to normal
+	if( mHovered >= 0 && mHovered != hit )
+	{
+		mButtons[ mHovered ]->setSprite( BUTTON_SPRITE_MOUSE_OUT );
+	}
+	mHovered = hit;
+
+	//Only the button under the mouse reacts
+	if( hit >= 0 )
+	{
+		switch( e->type )
+		{
+			case SDL_MOUSEMOTION:
+				mButtons[ hit ]->setSprite( BUTTON_SPRITE_MOUSE_OVER_MOTION );
+				break;
+
+			case SDL_MOUSEBUTTONDOWN:
+				mButtons[ hit ]->setSprite( BUTTON_SPRITE_MOUSE_DOWN );
+				break;
+
+			case SDL_MOUSEBUTTONUP:
+				mButtons[ hit ]->setSprite( BUTTON_SPRITE_MOUSE_UP );
+				break;
+		}
+	}
+}
+
+int LButtonGrid::getCount()
+{
+	return mButtons.size();
+}
+
+int LButtonGrid::find( int x, int y )
+{
+	if( x < 0 || y < 0 || x >= mColumns * mCellSize || y >= mRows * mCellSize )
+	{
+		return -1;
+	}
+
+	//Latest first, it's on top
+	const std::vector<int>& cell = mCells[ ( y / mCellSize ) * mColumns + x / mCellSize ];
+	for( int i = cell.size() - 1; i >= 0; --i )
+	{
+		if( mButtons[ cell[ i ] ]->contains( x, y ) )
+		{
+			return cell[ i ];
+		}
+	}
+
+	return -1;
+}
@@ -0,0 +1,320 @@
+//Input log
+//Records the keyboard and mouse events a main loop handles, each with the
+//frame it was handled on, and plays them back on the same frames. Replayed
+//input doesn't depend on how fast frames run, so runs of different builds
+//see exactly the same events and their frame times can be compared.
+//The file is a magic number and version followed by the event count and one
+//24 byte little endian record per event
+class LInputLog
+{
+	public:
+		//Log file identification
+		static const Uint32 LOG_MAGIC = 0x474C4E49;
+		static const Uint32 LOG_VERSION = 1;
+
+		//Initializes variables
+		LInputLog();
+
+		//Adds an event handled on the given frame, events that aren't input are skipped
+		void record( const SDL_Event& e, int frame );
+
+		//Writes the log to a file
+		bool saveToFile( std::string path );
+
+		//Reads a log from a file and starts playback from its beginning
+		bool loadFromFile( std::string path );
+
+		//Takes the next event logged on or before frame, in place of SDL_PollEvent
+		bool poll( int frame, SDL_Event* e );
+
+		//Pushes the events logged on or before frame onto SDL's event queue
+		void replay( int frame );
+
+		//Removes every event
+		void clear();
+
+		//Gets the number of events logged
+		int getEventCount();
+
+		//Gets the number of frames the log covers
+		int getFrameCount();
+
+		//Checks whether every event has been played back
+		bool isFinished();
+
+	private:
+		//A logged event; key events keep their scancode and modifiers in x and y
+		struct Record
+		{
+			Uint32 frame;
+			Uint32 tick;
+			Uint16 type;
+			Uint8 state;
+			Uint8 extra;
+			Sint32 code;
+			Sint16 x;
+			Sint16 y;
+			Sint16 xrel;
+			Sint16 yrel;
+		};
+
+		//Checks whether an event type is logged
+		static bool isLogged( Uint32 type );
+
+		//Logged events in order and the next one to play back
+		std::vector<Record> mRecords;
+		size_t mNext;
+};
+
+LInputLog::LInputLog()
+{
+	//Initialize
+	mNext = 0;
+}
+
+void LInputLog::record( const SDL_Event& e, int frame )
+{
+	if( !isLogged( e.type ) )
+	{
+		return;
+	}
+
+	Record record;
+	SDL_zero( record );
+	record.frame = frame;
+	record.tick = e.common.timestamp;
+	record.type = e.type;
+
+	switch( e.type )
+	{
+		case SDL_KEYDOWN:
+		case SDL_KEYUP:
+			record.state = e.key.state;
+			record.extra = e.key.repeat;
+			record.code = e.key.keysym.sym;
+			record.x = e.key.keysym.scancode;
+			record.y = e.key.keysym.mod;
+			break;
+
+		case SDL_MOUSEMOTION:
+			record.code = e.motion.state;
+			record.x = e.motion.x;
+			record.y = e.motion.y;
+			record.xrel = e.motion.xrel;
+			record.yrel = e.motion.yrel;
+			break;
+
+		case SDL_MOUSEBUTTONDOWN:
+		case SDL_MOUSEBUTTONUP:
+			record.state = e.button.state;
+			record.extra = e.button.clicks;
+			record.code = e.button.button;
+			record.x = e.button.x;
+			record.y = e.button.y;
+			break;
+
+		case SDL_MOUSEWHEEL:
+			record.code = e.wheel.direction;
+			record.x = e.wheel.x;
+			record.y = e.wheel.y;
+			break;
+	}
+
+	mRecords.push_back( record );
+}
+
+bool LInputLog::saveToFile( std::string path )
+{
+	SDL_RWops* file = SDL_RWFromFile( path.c_str(), "wb" );
+	if( file == NULL )
+	{
+		printf( "Unable to write input log %s! SDL Error: %s\n", path.c_str(), SDL_GetError() );
+		return false;
+	}
+
+	//Every field is written on its own so the file is the same on any machine
+	bool success = SDL_WriteLE32( file, LOG_MAGIC ) && SDL_WriteLE32( file, LOG_VERSION ) && SDL_WriteLE32( file, mRecords.size() );
+	for( size_t i = 0; i < mRecords.size() && success; ++i )
+	{
+		const Record& record = mRecords[ i ];
+		success = SDL_WriteLE32( file, record.frame ) && SDL_WriteLE32( file, record.tick ) &&
+			SDL_WriteLE16( file, record.type ) && SDL_WriteU8( file, record.state ) && SDL_WriteU8( file, record.extra ) &&
+			SDL_WriteLE32( file, record.code ) &&
+			SDL_WriteLE16( file, record.x ) && SDL_WriteLE16( file, record.y ) &&
+			SDL_WriteLE16( file, record.xrel ) && SDL_WriteLE16( file, record.yrel );
+	}
+
+	if( SDL_RWclose( file ) != 0 )
+	{
+		success = false;
+	}
+
+	if( !success )
+	{
+		printf( "Unable to write input log %s! SDL Error: %s\n", path.c_str(), SDL_GetError() );
+	}
+
+	return success;
+}
+
+bool LInputLog::loadFromFile( std::string path )
+{
+	clear();
+
+	SDL_RWops* file = SDL_RWFromFile( path.c_str(), "rb" );
+	if( file == NULL )
+	{
+		printf( "Unable to open input log %s! SDL Error: %s\n", path.c_str(), SDL_GetError() );
+		return false;
+	}
+
+	bool success = true;
+	if( SDL_ReadLE32( file ) != LOG_MAGIC || SDL_ReadLE32( file ) != LOG_VERSION )
+	{
+		printf( "%s is not an input log!\n", path.c_str() );
+		success = false;
+	}
+	else
+	{
+		//A short file can't claim more records than it has room for
+		Uint32 count = SDL_ReadLE32( file );
+		Sint64 size = SDL_RWsize( file );
+		if( size >= 0 && count > ( size - 12 ) / 24 )
+		{
+			printf( "Input log %s is truncated!\n", path.c_str() );
+			success = false;
+		}
+		else
+		{
+			mRecords.resize( count );
+			for( Uint32 i = 0; i < count; ++i )
+			{
+				Record& record = mRecords[ i ];
+				record.frame = SDL_ReadLE32( file );
+				record.tick = SDL_ReadLE32( file );
+				record.type = SDL_ReadLE16( file );
+				record.state = SDL_ReadU8( file );
+				record.extra = SDL_ReadU8( file );
+				record.code = SDL_ReadLE32( file );
+				record.x = SDL_ReadLE16( file );
+				record.y = SDL_ReadLE16( file );
+				record.xrel = SDL_ReadLE16( file );
+				record.yrel = SDL_ReadLE16( file );
+
+				//Frames only go forward
+				if( !isLogged( record.type ) || ( i > 0 && record.frame < mRecords[ i - 1 ].frame ) )
+				{
+					printf( "Input log %s is corrupt!\n", path.c_str() );
+					success = false;
+					break;
+				}
+			}
+		}
+	}
+
+	SDL_RWclose( file );
+
+	if( !success )
+	{
+		clear();
+	}
+
+	return success;
+}
+
+bool LInputLog::poll( int frame, SDL_Event* e )
+{
+	if( mNext >= mRecords.size() || mRecords[ mNext ].frame > frame )
+	{
+		return false;
+	}
+
+	const Record& record = mRecords[ mNext++ ];
+	SDL_zerop( e );
+	e->type = record.type;
+	e->common.timestamp = record.tick;
+
+	switch( record.type )
+	{
+		case SDL_KEYDOWN:
+		case SDL_KEYUP:
+			e->key.state = record.state;
+			e->key.repeat = record.extra;
+			e->key.keysym.sym = record.code;
+			e->key.keysym.scancode = (SDL_Scancode)(Uint16)record.x;
+			e->key.keysym.mod = (Uint16)record.y;
+			break;
+
+		case SDL_MOUSEMOTION:
+			e->motion.state = record.code;
+			e->motion.x = record.x;
+			e->motion.y = record.y;
+			e->motion.xrel = record.xrel;
+			e->motion.yrel = record.yrel;
+			break;
+
+		case SDL_MOUSEBUTTONDOWN:
+		case SDL_MOUSEBUTTONUP:
+			e->button.state = record.state;
+			e->button.clicks = record.extra;
+			e->button.button = record.code;
+			e->button.x = record.x;
+			e->button.y = record.y;
+			break;
+
+		case SDL_MOUSEWHEEL:
+			e->wheel.direction = record.code;
+			e->wheel.x = record.x;
+			e->wheel.y = record.y;
+			break;
+	}
+
+	return true;
+}
+
+void LInputLog::replay( int frame )
+{
+	SDL_Event e;
+	while( poll( frame, &e ) )
+	{
+		SDL_PushEvent( &e );
+	}
+}
+
+void LInputLog::clear()
+{
+	mRecords.clear();
+	mNext = 0;
+}
+
+int LInputLog::getEventCount()
+{
+	return mRecords.size();
+}
+
+int LInputLog::getFrameCount()
+{
+	return mRecords.empty() ? 0 : mRecords.back().frame + 1;
+}
+
+bool LInputLog::isFinished()
+{
+	return mNext >= mRecords.size();
+}
+
+bool LInputLog::isLogged( Uint32 type )
+{
+	switch( type )
+	{
+		case SDL_QUIT:
+		case SDL_KEYDOWN:
+		case SDL_KEYUP:
+		case SDL_MOUSEMOTION:
+		case SDL_MOUSEBUTTONDOWN:
+		case SDL_MOUSEBUTTONUP:
+		case SDL_MOUSEWHEEL:
+			return true;
+	}
+
+	return false;
+}
@@ -31,6 +31,9 @@ class LTexture
 		//Renders texture at given point
 		void render( SDL_Renderer* renderer = NULL, int x=0, int y=0, SDL_Rect* clip = NULL, double angle = 0.0, SDL_Point* center = NULL, SDL_RendererFlip flip = SDL_FLIP_NONE );
 
+		//Renders texture stretched over quad
+		void renderScaled( SDL_Renderer* renderer, const SDL_Rect& quad, SDL_Rect* clip = NULL );
+
 		//Gets image dimensions
 		int getWidth();
 		int getHeight();
@@ -181,6 +184,12 @@ void LTexture::render( SDL_Renderer* renderer, int x, int y, SDL_Rect* clip, dou
 	SDL_RenderCopyEx( renderer, mTexture, clip, &renderQuad, angle, center, flip );
 }
 
+void LTexture::renderScaled( SDL_Renderer* renderer, const SDL_Rect& quad, SDL_Rect* clip )
+{
+	//Render to screen
+	SDL_RenderCopy( renderer, mTexture, clip, &quad );
+}
+
 int LTexture::getWidth()
 {
 	return mWidth;
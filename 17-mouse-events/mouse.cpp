@@ -1,10 +1,17 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <cmath>
 #include "LTexture.h"
 #include "LButton.h"
+#include "LButtonGrid.h"
+#include "LInputQueue.h"
+#include "LInputLog.h"
+#include "LBenchmark.h"
 
 //Screen dimension constants
 const int SCREEN_WIDTH = 600;
@@ -19,6 +26,9 @@ bool loadMedia();
 //Frees media and shuts down SDL
 void close();
 
+//Places the four lesson buttons, or rows of cells about columns to a row if given
+void layoutButtons( int columns, int rows );
+
 //The window we'll be rendering to
 SDL_Window* gWindow = NULL;
 
@@ -26,11 +36,20 @@ SDL_Window* gWindow = NULL;
 SDL_Renderer* gRenderer = NULL;
 
 //The buttons
-LButton gButtons[ TOTAL_BUTTONS ];
+std::vector<LButton> gButtons;
+
+//Finds the button under the mouse, cells small enough for a few tiny buttons each
+LButtonGrid gButtonGrid( SCREEN_WIDTH, SCREEN_HEIGHT, 16 );
 
 //Textures
 LTexture gButtonsSpriteSheetTexture;
 
+//Input events, stamped as SDL receives them
+LInputQueue gInputQueue;
+
+//Headless benchmark mode, replaying recorded mouse input
+LBenchmark gBenchmark;
+
 bool init()
 {
 	//Initialization flag
@@ -95,19 +114,57 @@ bool loadMedia()
 		printf( "Failed to load texture image!\n" );
 		success = false;
 	}
-	else
+
+	return success;
+}
+
+void layoutButtons( int columns, int rows )
+{
+	gButtons.clear();
+	gButtonGrid.clear();
+
+	if( columns <= 0 || rows <= 0 )
 	{
+		//The lesson's four buttons
+		gButtons.resize( TOTAL_BUTTONS );
 		gButtons[ 0 ].setPosition( 0, 0 );
 		gButtons[ 1 ].setPosition( BUTTON_WIDTH, 0 );
 		gButtons[ 2 ].setPosition( 0, BUTTON_HEIGHT );
 		gButtons[ 3 ].setPosition( BUTTON_WIDTH, BUTTON_HEIGHT );
 	}
+	else
+	{
+		//Rows of cells of random widths, like a tool's palette
+		int cellWidth = SDL_max( SCREEN_WIDTH / columns, 2 );
+		int cellHeight = SDL_max( SCREEN_HEIGHT / rows, 1 );
+		for( int y = 0; y + cellHeight <= SCREEN_HEIGHT; y += cellHeight )
+		{
+			int x = 0;
+			while( x < SCREEN_WIDTH )
+			{
+				int width = SDL_min( cellWidth / 2 + rand() % cellWidth + 1, SCREEN_WIDTH - x );
+
+				LButton button;
+				button.setPosition( x, y );
+				button.setSize( width, cellHeight );
+				gButtons.push_back( button );
+				x += width;
+			}
+		}
+	}
 
-	return success;
+	//Index them once they're all in place, the vector won't move them again
+	for( int i = 0; i < gButtons.size(); ++i )
+	{
+		gButtonGrid.add( &gButtons[ i ] );
+	}
 }
 
 void close()
 {
+	//Give events back to SDL
+	gInputQueue.stop();
+
 	//Free loaded images
 	gButtonsSpriteSheetTexture.free();
 
@@ -125,6 +182,9 @@ void close()
 
 int main( int argc, char* args[] )
 {
+	//Run headless if the benchmark runner started us
+	gBenchmark.configure( "mouse" );
+
 	//Start up SDL and create window
 	if( !init() )
 	{
@@ -139,18 +199,44 @@ int main( int argc, char* args[] )
 		}
 		else
 		{	
+			//Lay out buttons, mouse [columns rows] makes a grid of cells for stress testing
+			layoutButtons( argc > 2 ? atoi( args[ 1 ] ) : 0, argc > 2 ? atoi( args[ 2 ] ) : 0 );
+
 			//Main loop flag
 			bool quit = false;
 
 			//Event handler
-			SDL_Event e;
+			LInputEvent input;
+
+			//Events other than input, which stay in SDL's queue
+			SDL_Event event;
+
+			//Take events as they arrive instead of from SDL's queue
+			gInputQueue.start();
+
+			gBenchmark.markLoaded();
 
 			//While application is running
 			while( !quit )
 			{
+				//Replayed input goes through the queue like live input
+				gBenchmark.beginFrame();
+
 				//Handle events on queue
-				while( SDL_PollEvent( &e ) != 0 )
+				gInputQueue.pump();
+
+				//Nothing here needs window events, SDL's renderer has already seen them, but they mustn't pile up
+				while( SDL_PollEvent( &event ) != 0 )
 				{
+				}
+
+				while( gInputQueue.pop( input ) )
+				{
+					SDL_Event& e = input.event;
+
+					//Keep it for replay if recording
+					gBenchmark.recordEvent( e );
+
 					//User requests quit
 					if( e.type == SDL_QUIT )
 					{
@@ -169,11 +255,8 @@ int main( int argc, char* args[] )
 						}
 					}
 
-					//Handle button events
-					for( int i = 0; i < TOTAL_BUTTONS; ++i )
-					{
-						gButtons[ i ].handleEvent( &e );
-					}
+					//Handle button events, only the buttons under and just left by the mouse change
+					gButtonGrid.handleEvent( &e );
 				}
 
 				//Clear screen
@@ -181,14 +264,18 @@ int main( int argc, char* args[] )
 				SDL_RenderClear( gRenderer );
 
 				//Render buttons
-				for( int i = 0; i < TOTAL_BUTTONS; ++i )
+				for( int i = 0; i < gButtons.size(); ++i )
 				{
 					gButtons[ i ].render( gRenderer, &gButtonsSpriteSheetTexture );
 				}
 
 				//Update screen
 				SDL_RenderPresent( gRenderer );
+
+				gBenchmark.endFrame();
 			}
+
+			gBenchmark.report();
 		}
 	}
 
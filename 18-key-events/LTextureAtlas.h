@@ -0,0 +1,124 @@
+//Texture atlas wrapper class
+//Loads an atlas image packed by tools/atlaspack and looks up its clips by name
+class LTextureAtlas
+{
+	public:
+		//Index file identification written by atlaspack
+		static const Uint32 ATLAS_MAGIC = 0x5441544C;
+		static const Uint32 ATLAS_VERSION = 1;
+
+		//Loads atlas image and clip index at specified paths
+		bool loadFromFile( SDL_Renderer* renderer, std::string imagePath, std::string indexPath );
+
+		//Deallocates atlas
+		void free();
+
+		//Gets the clip for an image name, NULL if the atlas doesn't contain it
+		SDL_Rect* getClip( std::string name );
+
+		//Gets the atlas texture
+		LTexture* getTexture();
+
+	private:
+		//The packed images
+		LTexture mTexture;
+
+		//Clip rectangles by image name
+		std::map<std::string, SDL_Rect> mClips;
+};
+
+bool LTextureAtlas::loadFromFile( SDL_Renderer* renderer, std::string imagePath, std::string indexPath )
+{
+	//Get rid of preexisting atlas
+	free();
+
+	//Open clip index
+	SDL_RWops* file = SDL_RWFromFile( indexPath.c_str(), "rb" );
+	if( file == NULL )
+	{
+		printf( "Unable to open atlas index %s! SDL Error: %s\n", indexPath.c_str(), SDL_GetError() );
+		return false;
+	}
+
+	//Read clip index
+	bool success = true;
+	if( SDL_ReadLE32( file ) != ATLAS_MAGIC || SDL_ReadLE32( file ) != ATLAS_VERSION )
+	{
+		printf( "%s is not an atlas index!\n", indexPath.c_str() );
+		success = false;
+	}
+	else
+	{
+		Uint32 count = SDL_ReadLE32( file );
+		for( Uint32 i = 0; i < count && success; ++i )
+		{
+			//Name length, name, then x, y, w and h as little endian Uint16s
+			char name[ 256 ];
+			Uint8 length = 0;
+			Uint8 bytes[ 8 ];
+			if( SDL_RWread( file, &length, 1, 1 ) != 1 || SDL_RWread( file, name, 1, length ) != length || SDL_RWread( file, bytes, 1, 8 ) != 8 )
+			{
+				printf( "Atlas index %s is truncated!\n", indexPath.c_str() );
+				success = false;
+			}
+			else
+			{
+				SDL_Rect clip;
+				clip.x = bytes[ 0 ] | bytes[ 1 ] << 8;
+				clip.y = bytes[ 2 ] | bytes[ 3 ] << 8;
+				clip.w = bytes[ 4 ] | bytes[ 5 ] << 8;
+				clip.h = bytes[ 6 ] | bytes[ 7 ] << 8;
+				mClips[ std::string( name, length ) ] = clip;
+			}
+		}
+	}
+
+	SDL_RWclose( file );
+
+	//Load atlas image
+	if( success && !mTexture.loadFromFile( renderer, imagePath ) )
+	{
+		success = false;
+	}
+
+	//Every clip has to lie on the atlas, an index made for another image would draw garbage
+	for( std::map<std::string, SDL_Rect>::iterator it = mClips.begin(); it != mClips.end() && success; ++it )
+	{
+		SDL_Rect& clip = it->second;
+		if( clip.w <= 0 || clip.h <= 0 || clip.x + clip.w > mTexture.getWidth() || clip.y + clip.h > mTexture.getHeight() )
+		{
+			printf( "Clip %s is outside atlas %s!\n", it->first.c_str(), imagePath.c_str() );
+			success = false;
+		}
+	}
+
+	if( !success )
+	{
+		free();
+	}
+
+	return success;
+}
+
+void LTextureAtlas::free()
+{
+	//Free texture and clips
+	mTexture.free();
+	mClips.clear();
+}
+
+SDL_Rect* LTextureAtlas::getClip( std::string name )
+{
+	std::map<std::string, SDL_Rect>::iterator it = mClips.find( name );
+	if( it == mClips.end() )
+	{
+		return NULL;
+	}
+
+	return &it->second;
+}
+
+LTexture* LTextureAtlas::getTexture()
+{
+	return &mTexture;
+}
@@ -3,7 +3,10 @@
 #include <stdio.h>
 #include <string>
 #include <cmath>
+#include <map>
 #include "LTexture.h"
+#include "LTextureAtlas.h"
+#include "LInputQueue.h"
 
 //Screen dimension constants
 const int SCREEN_WIDTH = 640;
@@ -24,12 +27,18 @@ SDL_Window* gWindow = NULL;
 //The window renderer
 SDL_Renderer* gRenderer = NULL;
 
-//Textures
-LTexture gPressTexture;
-LTexture gUpTexture;
-LTexture gDownTexture;
-LTexture gLeftTexture;
-LTexture gRightTexture;
+//Key images packed into one texture
+LTextureAtlas gKeysAtlas;
+
+//Clips of the key images in the atlas
+SDL_Rect* gPressClip = NULL;
+SDL_Rect* gUpClip = NULL;
+SDL_Rect* gDownClip = NULL;
+SDL_Rect* gLeftClip = NULL;
+SDL_Rect* gRightClip = NULL;
+
+//Input events, stamped as SDL receives them
+LInputQueue gInputQueue;
 
 bool init()
 {
@@ -89,39 +98,26 @@ bool loadMedia()
 	//Loading success flag
 	bool success = true;
 
-	//Load press texture
-	if( !gPressTexture.loadFromFile( gRenderer, "textures/press.png" ) )
-	{
-		printf( "Failed to load press texture!\n" );
-		success = false;
-	}
-
-	//Load up texture
-	if( !gUpTexture.loadFromFile( gRenderer, "textures/up.png" ) )
-	{
-		printf( "Failed to load up texture!\n" );
-		success = false;
-	}
-
-	//Load down texture
-	if( !gDownTexture.loadFromFile( gRenderer, "textures/down.png" ) )
-	{
-		printf( "Failed to load down texture!\n" );
-		success = false;
-	}
-
-	//Load left texture
-	if( !gLeftTexture.loadFromFile( gRenderer, "textures/left.png" ) )
+	//Load key atlas
+	if( !gKeysAtlas.loadFromFile( gRenderer, "textures/keys.png", "textures/keys.atlas" ) )
 	{
-		printf( "Failed to load left texture!\n" );
+		printf( "Failed to load key atlas!\n" );
 		success = false;
 	}
-	
-	//Load right texture
-	if( !gRightTexture.loadFromFile( gRenderer, "textures/right.png" ) )
+	else
 	{
-		printf( "Failed to load right texture!\n" );
-		success = false;
+		//Look up the key clips
+		gPressClip = gKeysAtlas.getClip( "press" );
+		gUpClip = gKeysAtlas.getClip( "up" );
+		gDownClip = gKeysAtlas.getClip( "down" );
+		gLeftClip = gKeysAtlas.getClip( "left" );
+		gRightClip = gKeysAtlas.getClip( "right" );
+
+		if( gPressClip == NULL || gUpClip == NULL || gDownClip == NULL || gLeftClip == NULL || gRightClip == NULL )
+		{
+			printf( "Key atlas is missing a key image!\n" );
+			success = false;
+		}
 	}
 
 	return success;
@@ -129,12 +125,11 @@ bool loadMedia()
 
 void close()
 {
+	//Give events back to SDL
+	gInputQueue.stop();
+
 	//Free loaded images
-	gPressTexture.free();
- 	gUpTexture.free();
- 	gDownTexture.free();
- 	gLeftTexture.free();
- 	gRightTexture.free();
+	gKeysAtlas.free();
 
 	//Destroy window	
 	SDL_DestroyRenderer( gRenderer );
@@ -168,57 +163,80 @@ int main( int argc, char* args[] )
 			bool quit = false;
 
 			//Event handler
-			SDL_Event e;
+			LInputEvent input;
 
-			//Current rendered texture
-			LTexture* currentTexture = NULL;
+			//Events other than input, which stay in SDL's queue
+			SDL_Event event;
+
+			//Keys held down, as the key events have told us
+			bool keysDown[ SDL_NUM_SCANCODES ] = { false };
+
+			//Current rendered clip
+			SDL_Rect* currentClip = NULL;
+
+			//Take events as they arrive instead of from SDL's queue
+			gInputQueue.start();
 
 			//While application is running
 			while( !quit )
 			{
 				//Handle events on queue
-				while( SDL_PollEvent( &e ) != 0 )
+				gInputQueue.pump();
+
+				//Nothing here needs window events, SDL's renderer has already seen them, but they mustn't pile up
+				while( SDL_PollEvent( &event ) != 0 )
 				{
+				}
+
+				while( gInputQueue.pop( input ) )
+				{
+					SDL_Event& e = input.event;
+
 					//User requests quit
 					if( e.type == SDL_QUIT )
 					{
 						quit = true;
 					}
+
+					//Follow the keys from the events themselves, in the order they happened
+					else if( e.type == SDL_KEYDOWN || e.type == SDL_KEYUP )
+					{
+						keysDown[ e.key.keysym.scancode ] = e.type == SDL_KEYDOWN;
+					}
 				}
 
 				//Set texture based on current keystate
-				const Uint8* currentKeyStates = SDL_GetKeyboardState( NULL );
-				if( currentKeyStates[ SDL_SCANCODE_Q ] )
+				if( keysDown[ SDL_SCANCODE_Q ] )
 				{
 					quit = true;
 				}
-				if( currentKeyStates[ SDL_SCANCODE_UP ] )
+				if( keysDown[ SDL_SCANCODE_UP ] )
 				{
-					currentTexture = &gUpTexture;
+					currentClip = gUpClip;
 				}
-				else if( currentKeyStates[ SDL_SCANCODE_DOWN ] )
+				else if( keysDown[ SDL_SCANCODE_DOWN ] )
 				{
-					currentTexture = &gDownTexture;
+					currentClip = gDownClip;
 				}
-				else if( currentKeyStates[ SDL_SCANCODE_LEFT ] )
+				else if( keysDown[ SDL_SCANCODE_LEFT ] )
 				{
-					currentTexture = &gLeftTexture;
+					currentClip = gLeftClip;
 				}
-				else if( currentKeyStates[ SDL_SCANCODE_RIGHT ] )
+				else if( keysDown[ SDL_SCANCODE_RIGHT ] )
 				{
-					currentTexture = &gRightTexture;
+					currentClip = gRightClip;
 				}
 				else
 				{
-					currentTexture = &gPressTexture;
+					currentClip = gPressClip;
 				}
 
 				//Clear screen
 				SDL_SetRenderDrawColor( gRenderer, 0x5F, 0x5F, 0x5F, 0xFF );
 				SDL_RenderClear( gRenderer );
 
-				//Render current texture
-				currentTexture->render( gRenderer );
+				//Render current clip
+				gKeysAtlas.getTexture()->render( gRenderer, 0, 0, currentClip );
 
 
 				//Update screen
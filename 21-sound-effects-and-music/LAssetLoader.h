@@ -0,0 +1,518 @@
+//Asynchronous asset loader
+//Worker threads read and decode asset files while the main thread keeps
+//running. Only the steps that need the main thread, creating textures and
+//opening decoded fonts and music, happen in update(). Assets found in the
+//asset pack are read from its mapping instead of their own files
+
+//Asset kinds the loader knows how to decode
+enum LAssetType
+{
+	ASSET_IMAGE,
+	ASSET_CHUNK,
+	ASSET_MUSIC,
+	ASSET_FONT
+};
+
+//Progress of a single asset
+enum LAssetState
+{
+	ASSET_QUEUED,
+	ASSET_READY,
+	ASSET_FAILED
+};
+
+//Completion handle for a queued asset, only checked from the main thread
+class LAsset
+{
+	public:
+		//Checks whether the asset finished loading
+		bool isDone();
+		bool isReady();
+		bool hasFailed();
+
+	private:
+		friend class LAssetLoader;
+
+		LAsset();
+		~LAsset();
+
+		//What to load and where to put it
+		LAssetType mType;
+		std::string mPath;
+		int mFontSize;
+		void* mTarget;
+
+		//Current progress, only changed by update()
+		LAssetState mState;
+
+		//Decoded data handed from the worker to the main thread
+		bool mDecodeSucceeded;
+		SDL_Surface* mSurface;
+		void* mChunk;
+		const void* mData;
+		size_t mDataSize;
+		bool mOwnsData;
+};
+
+class LAssetLoader
+{
+	public:
+		//Initializes variables
+		LAssetLoader();
+
+		//Stops the workers and deallocates memory
+		~LAssetLoader();
+
+		//Starts the worker threads, one per CPU when count is 0
+		bool start( int workerCount = 0 );
+
+		//Waits for the workers to finish their current asset and stops them
+		void stop();
+
+		//Reads assets from the pack when it holds them, set before queueing
+		void setPack( LAssetPack* pack );
+
+		//Queues an image to be loaded into the texture
+		LAsset* loadImage( LTexture* texture, std::string path );
+
+#if defined(SDL_MIXER_MAJOR_VERSION)
+		//Queues a sound effect or music to be loaded into the pointer
+		LAsset* loadChunk( Mix_Chunk** chunk, std::string path );
+		LAsset* loadMusic( Mix_Music** music, std::string path );
+#endif
+
+#if defined(SDL_TTF_MAJOR_VERSION)
+		//Queues a font to be opened into the pointer
+		LAsset* loadFont( TTF_Font** font, std::string path, int size );
+#endif
+
+		//Finishes decoded assets on the main thread
+		void update( SDL_Renderer* renderer );
+
+		//Blocks until the asset is done
+		void wait( SDL_Renderer* renderer, LAsset* asset );
+
+		//Gets the fraction of queued assets that are done
+		float getProgress();
+
+		//Checks whether every queued asset is done and whether any failed
+		bool isDone();
+		bool hasFailed();
+
+	private:
+		//Worker thread entry point
+		static int workerThread( void* data );
+
+		//Decodes one asset on a worker thread
+		bool decode( LAsset* asset );
+
+		//Opens a stream over an asset in the pack or on disk
+		SDL_RWops* openAsset( std::string path );
+
+		//Adds an asset to the work queue
+		LAsset* queue( LAssetType type, void* target, std::string path, int fontSize = 0 );
+
+		//Mapped assets read in place of files
+		LAssetPack* mPack;
+
+		//The worker threads
+		std::vector<SDL_Thread*> mWorkers;
+		bool mQuit;
+
+		//Assets waiting for a worker, and decoded assets waiting for update()
+		std::deque<LAsset*> mQueued;
+		std::deque<LAsset*> mDecoded;
+
+		//Every asset handed out, kept for buffers loaded music and fonts still read
+		std::vector<LAsset*> mAssets;
+
+		//Counts for progress reporting
+		int mDoneCount;
+		bool mFailed;
+
+		//Guards the queues and asset states
+		SDL_mutex* mLock;
+		SDL_cond* mWorkAvailable;
+		SDL_cond* mWorkDecoded;
+};
+
+LAsset::LAsset()
+{
+	//Initialize
+	mType = ASSET_IMAGE;
+	mFontSize = 0;
+	mTarget = NULL;
+	mState = ASSET_QUEUED;
+	mDecodeSucceeded = false;
+	mSurface = NULL;
+	mChunk = NULL;
+	mData = NULL;
+	mDataSize = 0;
+	mOwnsData = false;
+}
+
+LAsset::~LAsset()
+{
+	//Free data the main thread never picked up
+	if( mSurface != NULL )
+	{
+		SDL_FreeSurface( mSurface );
+	}
+#if defined(SDL_MIXER_MAJOR_VERSION)
+	if( mChunk != NULL )
+	{
+		Mix_FreeChunk( (Mix_Chunk*)mChunk );
+	}
+#endif
+	if( mOwnsData )
+	{
+		SDL_free( (void*)mData );
+	}
+}
+
+bool LAsset::isDone()
+{
+	return mState == ASSET_READY || mState == ASSET_FAILED;
+}
+
+bool LAsset::isReady()
+{
+	return mState == ASSET_READY;
+}
+
+bool LAsset::hasFailed()
+{
+	return mState == ASSET_FAILED;
+}
+
+LAssetLoader::LAssetLoader()
+{
+	//Initialize
+	mPack = NULL;
+	mQuit = false;
+	mDoneCount = 0;
+	mFailed = false;
+	mLock = SDL_CreateMutex();
+	mWorkAvailable = SDL_CreateCond();
+	mWorkDecoded = SDL_CreateCond();
+}
+
+LAssetLoader::~LAssetLoader()
+{
+	//Deallocate
+	stop();
+
+	for( int i = 0; i < mAssets.size(); ++i )
+	{
+		delete mAssets[ i ];
+	}
+
+	SDL_DestroyCond( mWorkDecoded );
+	SDL_DestroyCond( mWorkAvailable );
+	SDL_DestroyMutex( mLock );
+}
+
+bool LAssetLoader::start( int workerCount )
+{
+	if( workerCount <= 0 )
+	{
+		workerCount = SDL_GetCPUCount();
+	}
+
+	mQuit = false;
+	for( int i = 0; i < workerCount; ++i )
+	{
+		SDL_Thread* worker = SDL_CreateThread( workerThread, "LAssetLoader", this );
+		if( worker == NULL )
+		{
+			printf( "Unable to create loader thread! SDL Error: %s\n", SDL_GetError() );
+			break;
+		}
+		mWorkers.push_back( worker );
+	}
+
+	return !mWorkers.empty();
+}
+
+void LAssetLoader::stop()
+{
+	//Wake every worker up to see the quit flag
+	SDL_LockMutex( mLock );
+	mQuit = true;
+	SDL_CondBroadcast( mWorkAvailable );
+	SDL_UnlockMutex( mLock );
+
+	for( int i = 0; i < mWorkers.size(); ++i )
+	{
+		SDL_WaitThread( mWorkers[ i ], NULL );
+	}
+	mWorkers.clear();
+}
+
+void LAssetLoader::setPack( LAssetPack* pack )
+{
+	mPack = pack;
+}
+
+SDL_RWops* LAssetLoader::openAsset( std::string path )
+{
+	if( mPack != NULL && mPack->contains( path ) )
+	{
+		return mPack->open( path );
+	}
+
+	return SDL_RWFromFile( path.c_str(), "rb" );
+}
+
+LAsset* LAssetLoader::loadImage( LTexture* texture, std::string path )
+{
+	return queue( ASSET_IMAGE, texture, path );
+}
+
+#if defined(SDL_MIXER_MAJOR_VERSION)
+LAsset* LAssetLoader::loadChunk( Mix_Chunk** chunk, std::string path )
+{
+	return queue( ASSET_CHUNK, chunk, path );
+}
+
+LAsset* LAssetLoader::loadMusic( Mix_Music** music, std::string path )
+{
+	return queue( ASSET_MUSIC, music, path );
+}
+#endif
+
+#if defined(SDL_TTF_MAJOR_VERSION)
+LAsset* LAssetLoader::loadFont( TTF_Font** font, std::string path, int size )
+{
+	return queue( ASSET_FONT, font, path, size );
+}
+#endif
+
+LAsset* LAssetLoader::queue( LAssetType type, void* target, std::string path, int fontSize )
+{
+	LAsset* asset = new LAsset();
+	asset->mType = type;
+	asset->mTarget = target;
+	asset->mPath = path;
+	asset->mFontSize = fontSize;
+
+	//Hand it to the workers
+	SDL_LockMutex( mLock );
+	mAssets.push_back( asset );
+	mQueued.push_back( asset );
+	SDL_CondSignal( mWorkAvailable );
+	SDL_UnlockMutex( mLock );
+
+	return asset;
+}
+
+int LAssetLoader::workerThread( void* data )
+{
+	LAssetLoader* loader = (LAssetLoader*)data;
+
+	SDL_LockMutex( loader->mLock );
+	while( true )
+	{
+		//Sleep until there is work or the loader stops
+		while( loader->mQueued.empty() && !loader->mQuit )
+		{
+			SDL_CondWait( loader->mWorkAvailable, loader->mLock );
+		}
+
+		if( loader->mQuit )
+		{
+			break;
+		}
+
+		LAsset* asset = loader->mQueued.front();
+		loader->mQueued.pop_front();
+
+		//Decode without holding the lock
+		SDL_UnlockMutex( loader->mLock );
+		bool decoded = loader->decode( asset );
+		SDL_LockMutex( loader->mLock );
+
+		//Hand it to the main thread
+		asset->mDecodeSucceeded = decoded;
+		loader->mDecoded.push_back( asset );
+		SDL_CondSignal( loader->mWorkDecoded );
+	}
+	SDL_UnlockMutex( loader->mLock );
+
+	return 0;
+}
+
+bool LAssetLoader::decode( LAsset* asset )
+{
+	bool success = false;
+
+	switch( asset->mType )
+	{
+		case ASSET_IMAGE:
+			//Decode the image into a surface
+			asset->mSurface = IMG_Load_RW( openAsset( asset->mPath ), 1 );
+			success = asset->mSurface != NULL;
+			if( !success )
+			{
+				printf( "Unable to load image %s! SDL_image Error: %s\n", asset->mPath.c_str(), IMG_GetError() );
+			}
+			break;
+
+#if defined(SDL_MIXER_MAJOR_VERSION)
+		case ASSET_CHUNK:
+			//Decode and convert the samples to the output format
+			asset->mChunk = Mix_LoadWAV_RW( openAsset( asset->mPath ), 1 );
+			success = asset->mChunk != NULL;
+			if( !success )
+			{
+				printf( "Unable to load sound %s! SDL_mixer Error: %s\n", asset->mPath.c_str(), Mix_GetError() );
+			}
+			break;
+#endif
+
+		default:
+			//Music and fonts are streamed from memory, so only read the file here
+			if( mPack != NULL && mPack->contains( asset->mPath ) )
+			{
+				asset->mData = mPack->getData( asset->mPath, &asset->mDataSize );
+			}
+			else
+			{
+				asset->mData = SDL_LoadFile( asset->mPath.c_str(), &asset->mDataSize );
+				asset->mOwnsData = true;
+			}
+			success = asset->mData != NULL;
+			if( !success )
+			{
+				printf( "Unable to read %s! SDL Error: %s\n", asset->mPath.c_str(), SDL_GetError() );
+			}
+			break;
+	}
+
+	return success;
+}
+
+void LAssetLoader::update( SDL_Renderer* renderer )
+{
+	//Take the decoded assets
+	SDL_LockMutex( mLock );
+
+	//Without workers decode one asset per update on this thread
+	if( mWorkers.empty() && !mQueued.empty() )
+	{
+		LAsset* next = mQueued.front();
+		mQueued.pop_front();
+		next->mDecodeSucceeded = decode( next );
+		mDecoded.push_back( next );
+	}
+
+	std::deque<LAsset*> decoded;
+	decoded.swap( mDecoded );
+	SDL_UnlockMutex( mLock );
+
+	for( int i = 0; i < decoded.size(); ++i )
+	{
+		LAsset* asset = decoded[ i ];
+		bool success = asset->mDecodeSucceeded;
+
+		if( success )
+		{
+			switch( asset->mType )
+			{
+				case ASSET_IMAGE:
+					//Upload the surface
+					success = ( (LTexture*)asset->mTarget )->loadFromSurface( renderer, asset->mSurface );
+					SDL_FreeSurface( asset->mSurface );
+					asset->mSurface = NULL;
+					break;
+
+#if defined(SDL_MIXER_MAJOR_VERSION)
+				case ASSET_CHUNK:
+					*(Mix_Chunk**)asset->mTarget = (Mix_Chunk*)asset->mChunk;
+					asset->mChunk = NULL;
+					break;
+
+				case ASSET_MUSIC:
+					//The music keeps reading the buffer, which the loader or the pack owns
+					*(Mix_Music**)asset->mTarget = Mix_LoadMUS_RW( SDL_RWFromConstMem( asset->mData, asset->mDataSize ), 1 );
+					success = *(Mix_Music**)asset->mTarget != NULL;
+					if( !success )
+					{
+						printf( "Unable to load music %s! SDL_mixer Error: %s\n", asset->mPath.c_str(), Mix_GetError() );
+					}
+					break;
+#endif
+
+#if defined(SDL_TTF_MAJOR_VERSION)
+				case ASSET_FONT:
+					//The font keeps reading the buffer, which the loader or the pack owns
+					*(TTF_Font**)asset->mTarget = TTF_OpenFontRW( SDL_RWFromConstMem( asset->mData, asset->mDataSize ), 1, asset->mFontSize );
+					success = *(TTF_Font**)asset->mTarget != NULL;
+					if( !success )
+					{
+						printf( "Unable to load font %s! SDL_ttf Error: %s\n", asset->mPath.c_str(), TTF_GetError() );
+					}
+					break;
+#endif
+
+				default:
+					success = false;
+					break;
+			}
+		}
+
+		//Publish the result
+		SDL_LockMutex( mLock );
+		asset->mState = success ? ASSET_READY : ASSET_FAILED;
+		++mDoneCount;
+		if( !success )
+		{
+			mFailed = true;
+		}
+		SDL_UnlockMutex( mLock );
+	}
+}
+
+void LAssetLoader::wait( SDL_Renderer* renderer, LAsset* asset )
+{
+	update( renderer );
+	while( !asset->isDone() )
+	{
+		//Sleep until a worker finishes something
+		SDL_LockMutex( mLock );
+		if( mDecoded.empty() && !mWorkers.empty() )
+		{
+			SDL_CondWaitTimeout( mWorkDecoded, mLock, 10 );
+		}
+		SDL_UnlockMutex( mLock );
+
+		update( renderer );
+	}
+}
+
+float LAssetLoader::getProgress()
+{
+	SDL_LockMutex( mLock );
+	float progress = mAssets.empty() ? 1.f : (float)mDoneCount / mAssets.size();
+	SDL_UnlockMutex( mLock );
+
+	return progress;
+}
+
+bool LAssetLoader::isDone()
+{
+	SDL_LockMutex( mLock );
+	bool done = mDoneCount == mAssets.size();
+	SDL_UnlockMutex( mLock );
+
+	return done;
+}
+
+bool LAssetLoader::hasFailed()
+{
+	SDL_LockMutex( mLock );
+	bool failed = mFailed;
+	SDL_UnlockMutex( mLock );
+
+	return failed;
+}
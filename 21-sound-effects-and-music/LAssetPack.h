@@ -0,0 +1,188 @@
+//Memory mapped asset pack built by tools/assetpack
+//The whole pack is mapped once and assets are read in place through
+//SDL_RWFromConstMem, so no file is opened per asset
+class LAssetPack
+{
+	public:
+		//Pack file identification written by assetpack
+		static const Uint32 PACK_MAGIC = 0x4B41504C;
+		static const Uint32 PACK_VERSION = 1;
+
+		//Initializes variables
+		LAssetPack();
+
+		//Unmaps the pack
+		~LAssetPack();
+
+		//Maps the pack at specified path
+		bool loadFromFile( std::string path );
+
+		//Unmaps the pack, assets still reading it must be freed first
+		void free();
+
+		//Checks whether the pack holds an asset
+		bool contains( std::string name );
+
+		//Gets an asset's bytes inside the mapping, NULL if it isn't in the pack
+		const void* getData( std::string name, size_t* size );
+
+		//Opens a read only stream over an asset, NULL if it isn't in the pack
+		SDL_RWops* open( std::string name );
+
+	private:
+		//An asset inside the mapping
+		struct Blob
+		{
+			const Uint8* data;
+			size_t size;
+		};
+
+		//The mapped file
+		void* mMapping;
+		size_t mMappingSize;
+
+		//Assets by name
+		std::map<std::string, Blob> mBlobs;
+};
+
+LAssetPack::LAssetPack()
+{
+	//Initialize
+	mMapping = NULL;
+	mMappingSize = 0;
+}
+
+LAssetPack::~LAssetPack()
+{
+	//Deallocate
+	free();
+}
+
+bool LAssetPack::loadFromFile( std::string path )
+{
+	//Get rid of preexisting pack
+	free();
+
+	//Map the pack
+	int fd = ::open( path.c_str(), O_RDONLY );
+	if( fd < 0 )
+	{
+		printf( "Unable to open pack %s!\n", path.c_str() );
+		return false;
+	}
+
+	struct stat info;
+	if( fstat( fd, &info ) == 0 && info.st_size >= 16 )
+	{
+		mMapping = mmap( NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+		if( mMapping == MAP_FAILED )
+		{
+			mMapping = NULL;
+		}
+		else
+		{
+			mMappingSize = info.st_size;
+		}
+	}
+
+	//The mapping stays valid without the descriptor
+	::close( fd );
+
+	if( mMapping == NULL )
+	{
+		printf( "Unable to map pack %s!\n", path.c_str() );
+		return false;
+	}
+
+	//Read the header
+	const Uint8* bytes = (const Uint8*)mMapping;
+	Uint32 header[ 4 ];
+	memcpy( header, bytes, sizeof( header ) );
+	Uint32 count = SDL_SwapLE32( header[ 2 ] );
+	Uint32 tocSize = SDL_SwapLE32( header[ 3 ] );
+	if( SDL_SwapLE32( header[ 0 ] ) != PACK_MAGIC || SDL_SwapLE32( header[ 1 ] ) != PACK_VERSION || 16 + (size_t)tocSize > mMappingSize )
+	{
+		printf( "%s is not an asset pack!\n", path.c_str() );
+		free();
+		return false;
+	}
+
+	//Read the table of contents
+	const Uint8* toc = bytes + 16;
+	const Uint8* tocEnd = toc + tocSize;
+	for( Uint32 i = 0; i < count; ++i )
+	{
+		Uint64 offset, size;
+		Uint16 length;
+		if( tocEnd - toc < 18 )
+		{
+			break;
+		}
+		memcpy( &offset, toc, 8 );
+		memcpy( &size, toc + 8, 8 );
+		memcpy( &length, toc + 16, 2 );
+		offset = SDL_SwapLE64( offset );
+		size = SDL_SwapLE64( size );
+		length = SDL_SwapLE16( length );
+		toc += 18;
+
+		if( tocEnd - toc < length || offset > mMappingSize || size > mMappingSize - offset )
+		{
+			break;
+		}
+
+		Blob blob = { bytes + offset, (size_t)size };
+		mBlobs[ std::string( (const char*)toc, length ) ] = blob;
+		toc += length;
+	}
+
+	if( mBlobs.size() != count )
+	{
+		printf( "Asset pack %s is corrupt!\n", path.c_str() );
+		free();
+		return false;
+	}
+
+	return true;
+}
+
+void LAssetPack::free()
+{
+	//Unmap the pack if it is mapped
+	if( mMapping != NULL )
+	{
+		munmap( mMapping, mMappingSize );
+		mMapping = NULL;
+		mMappingSize = 0;
+	}
+	mBlobs.clear();
+}
+
+bool LAssetPack::contains( std::string name )
+{
+	return mBlobs.find( name ) != mBlobs.end();
+}
+
+const void* LAssetPack::getData( std::string name, size_t* size )
+{
+	std::map<std::string, Blob>::iterator it = mBlobs.find( name );
+	if( it == mBlobs.end() )
+	{
+		return NULL;
+	}
+
+	*size = it->second.size;
+	return it->second.data;
+}
+
+SDL_RWops* LAssetPack::open( std::string name )
+{
+	size_t size;
+	const void* data = getData( name, &size );
+	if( data == NULL )
+	{
+		return NULL;
+	}
+
+	return SDL_RWFromConstMem( data, size );
+}
@@ -11,6 +11,9 @@ class LTexture
 		//Loads image at specified path
 		bool loadFromFile( SDL_Renderer* renderer, std::string path );
 
+		//Creates image from an already decoded surface
+		bool loadFromSurface( SDL_Renderer* renderer, SDL_Surface* surface );
+
 		//Creates image from font string
 #if defined(SDL_TTF_MAJOR_VERSION)
 		bool loadFromRenderedText( SDL_Renderer* renderer, std::string textureText, TTF_Font* font, SDL_Color textColor );
@@ -99,6 +102,31 @@ bool LTexture::loadFromFile( SDL_Renderer* renderer, std::string path )
 	return mTexture != NULL;
 }
 
+bool LTexture::loadFromSurface( SDL_Renderer* renderer, SDL_Surface* surface )
+{
+	//Get rid of preexisting texture
+	free();
+
+	//Color key image
+	SDL_SetColorKey( surface, SDL_TRUE, SDL_MapRGB( surface->format, 0, 0xFF, 0xFF ) );
+
+	//Create texture from surface pixels
+	mTexture = SDL_CreateTextureFromSurface( renderer, surface );
+	if( mTexture == NULL )
+	{
+		printf( "Unable to create texture from surface! SDL Error: %s\n", SDL_GetError() );
+	}
+	else
+	{
+		//Get image dimensions
+		mWidth = surface->w;
+		mHeight = surface->h;
+	}
+
+	//Return success
+	return mTexture != NULL;
+}
+
 #if defined(SDL_TTF_MAJOR_VERSION)
 bool LTexture::loadFromRenderedText( SDL_Renderer* renderer, std::string textureText, TTF_Font* font, SDL_Color textColor )
 {
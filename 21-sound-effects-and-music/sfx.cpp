@@ -2,8 +2,18 @@
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_mixer.h>
 #include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <string>
+#include <vector>
+#include <deque>
+#include <map>
 #include "LTexture.h"
+#include "LAssetPack.h"
+#include "LAssetLoader.h"
 
 //Screen dimension constants
 const int SCREEN_WIDTH = 640;
@@ -36,6 +46,12 @@ Mix_Chunk* gHigh = NULL;
 Mix_Chunk* gMedium = NULL;
 Mix_Chunk* gLow = NULL;
 
+//The media bundled into one mapped file
+LAssetPack gMediaPack;
+
+//Loads the media on worker threads
+LAssetLoader gAssetLoader;
+
 bool init()
 {
 	//Initialization flag
@@ -102,47 +118,58 @@ bool loadMedia()
 	//Loading success flag
 	bool success = true;
 
-	//Load prompt texture
-	if( !gPromptTexture.loadFromFile( gRenderer, "tex/prompt.png" ) )
-	{
-		printf( "Failed to load prompt texture!\n" );
-		success = false;
-	}
-	
-	//Load music
-	gMusic = Mix_LoadMUS( "snd/beat.wav" );
-	if( gMusic == NULL )
+	//Read from the media pack when it was built, the loose files otherwise
+	if( gMediaPack.loadFromFile( "media.pak" ) )
 	{
-		printf( "Failed to load beat music! SDL_mixer Error: %s\n", Mix_GetError() );
-		success = false;
+		gAssetLoader.setPack( &gMediaPack );
 	}
 
-	//Load sound effects
-	gScratch = Mix_LoadWAV( "snd/scratch.wav" );
-	if( gScratch == NULL )
+	//Start the loader threads
+	if( !gAssetLoader.start() )
 	{
-		printf( "Failed to load scratch sound effect! SDL_mixer Error: %s\n", Mix_GetError() );
-		success = false;
+		printf( "Warning: Loading media on the main thread!\n" );
 	}
 
-	gHigh = Mix_LoadWAV( "snd/high.wav" );
-	if( gHigh == NULL )
-	{
-		printf( "Failed to load high sound effect! SDL_mixer Error: %s\n", Mix_GetError() );
-		success = false;
-	}
+	//Queue prompt texture
+	gAssetLoader.loadImage( &gPromptTexture, "tex/prompt.png" );
 
-	gMedium = Mix_LoadWAV( "snd/medium.wav" );
-	if( gMedium == NULL )
+	//Queue music
+	gAssetLoader.loadMusic( &gMusic, "snd/beat.wav" );
+
+	//Queue sound effects
+	gAssetLoader.loadChunk( &gScratch, "snd/scratch.wav" );
+	gAssetLoader.loadChunk( &gHigh, "snd/high.wav" );
+	gAssetLoader.loadChunk( &gMedium, "snd/medium.wav" );
+	gAssetLoader.loadChunk( &gLow, "snd/low.wav" );
+
+	//Show progress while the media decodes
+	while( !gAssetLoader.isDone() )
 	{
-		printf( "Failed to load medium sound effect! SDL_mixer Error: %s\n", Mix_GetError() );
-		success = false;
+		//Upload what the workers finished
+		gAssetLoader.update( gRenderer );
+
+		//Keep the window responsive
+		SDL_PumpEvents();
+
+		//Clear screen
+		SDL_SetRenderDrawColor( gRenderer, 0x5F, 0x5F, 0x5F, 0xFF );
+		SDL_RenderClear( gRenderer );
+
+		//Render progress bar
+		SDL_Rect bar = { SCREEN_WIDTH / 4, SCREEN_HEIGHT / 2 - 10, (int)( SCREEN_WIDTH / 2 * gAssetLoader.getProgress() ), 20 };
+		SDL_SetRenderDrawColor( gRenderer, 0xFF, 0xFF, 0xFF, 0xFF );
+		SDL_RenderFillRect( gRenderer, &bar );
+
+		//Update screen
+		SDL_RenderPresent( gRenderer );
 	}
 
-	gLow = Mix_LoadWAV( "snd/low.wav" );
-	if( gLow == NULL )
+	//The workers aren't needed anymore
+	gAssetLoader.stop();
+
+	if( gAssetLoader.hasFailed() )
 	{
-		printf( "Failed to load low sound effect! SDL_mixer Error: %s\n", Mix_GetError() );
+		printf( "Failed to load media!\n" );
 		success = false;
 	}
 
@@ -168,6 +195,9 @@ void close()
 	Mix_FreeMusic( gMusic );
 	gMusic = NULL;
 
+	//Unmap the media once nothing reads it
+	gMediaPack.free();
+
 	//Destroy window	
 	SDL_DestroyRenderer( gRenderer );
 	SDL_DestroyWindow( gWindow );
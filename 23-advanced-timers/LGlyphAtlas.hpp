@@ -0,0 +1,302 @@
+//Glyph atlas text renderer
+//Rasterizes every printable glyph of a font once into a single texture so
+//changing strings can be drawn every frame without creating new textures
+class LGlyphAtlas
+{
+	public:
+		//First and last characters stored in the atlas
+		static const int FIRST_GLYPH = 32;
+		static const int LAST_GLYPH = 126;
+
+		//Width of the atlas texture, rows are added until every glyph fits
+		static const int ATLAS_WIDTH = 512;
+
+		//Initializes variables
+		LGlyphAtlas();
+
+		//Deallocates memory
+		~LGlyphAtlas();
+
+		//Rasterizes the font's glyphs into the atlas texture
+		bool loadFromFont( SDL_Renderer* renderer, TTF_Font* font );
+
+		//Deallocates atlas
+		void free();
+
+		//Renders string at given point with one geometry call
+		void render( int x, int y, const char* text, SDL_Color color );
+		void render( int x, int y, const std::string& text, SDL_Color color );
+
+		//Gets rendered text dimensions
+		int getTextWidth( const char* text );
+		int getTextWidth( const std::string& text );
+		int getHeight();
+
+	private:
+		//Number of glyphs stored in the atlas
+		static const int GLYPH_COUNT = LAST_GLYPH - FIRST_GLYPH + 1;
+
+		//The atlas texture and the renderer it belongs to
+		SDL_Texture* mTexture;
+		SDL_Renderer* mRenderer;
+
+		//Atlas dimensions
+		int mWidth;
+		int mHeight;
+
+		//Line height of the font
+		int mLineHeight;
+
+		//Glyph location in the atlas and pen advance
+		SDL_Rect mGlyphClips[ GLYPH_COUNT ];
+		int mGlyphAdvance[ GLYPH_COUNT ];
+
+		//Quad buffers reused between frames
+		std::vector<SDL_Vertex> mVertices;
+		std::vector<int> mIndices;
+};
+
+LGlyphAtlas::LGlyphAtlas()
+{
+	//Initialize
+	mTexture = NULL;
+	mRenderer = NULL;
+	mWidth = 0;
+	mHeight = 0;
+	mLineHeight = 0;
+
+	for( int i = 0; i < GLYPH_COUNT; ++i )
+	{
+		mGlyphClips[ i ].x = 0;
+		mGlyphClips[ i ].y = 0;
+		mGlyphClips[ i ].w = 0;
+		mGlyphClips[ i ].h = 0;
+		mGlyphAdvance[ i ] = 0;
+	}
+}
+
+LGlyphAtlas::~LGlyphAtlas()
+{
+	//Deallocate
+	free();
+}
+
+bool LGlyphAtlas::loadFromFont( SDL_Renderer* renderer, TTF_Font* font )
+{
+	//Get rid of preexisting atlas
+	free();
+
+	//Set renderer for process
+	mRenderer = renderer;
+	mLineHeight = TTF_FontHeight( font );
+
+	//Glyphs are rendered white and tinted per draw through vertex colors
+	SDL_Color white = { 0xFF, 0xFF, 0xFF, 0xFF };
+
+	//Render each glyph and lay them out in rows
+	SDL_Surface* glyphSurfaces[ GLYPH_COUNT ];
+	int penX = 0;
+	int penY = 0;
+	int rowHeight = 0;
+	bool success = true;
+	for( int i = 0; i < GLYPH_COUNT; ++i )
+	{
+		Uint16 ch = FIRST_GLYPH + i;
+		glyphSurfaces[ i ] = NULL;
+
+		int minx, maxx, miny, maxy;
+		if( !TTF_GlyphIsProvided( font, ch ) || TTF_GlyphMetrics( font, ch, &minx, &maxx, &miny, &maxy, &mGlyphAdvance[ i ] ) < 0 )
+		{
+			continue;
+		}
+
+		glyphSurfaces[ i ] = TTF_RenderGlyph_Blended( font, ch, white );
+		if( glyphSurfaces[ i ] == NULL )
+		{
+			printf( "Unable to render glyph %d! SDL_ttf Error: %s\n", ch, TTF_GetError() );
+			success = false;
+			continue;
+		}
+
+		//Start a new row when this glyph doesn't fit, leaving a one pixel gutter against filtering bleed
+		int w = glyphSurfaces[ i ]->w;
+		int h = glyphSurfaces[ i ]->h;
+		if( penX + w > ATLAS_WIDTH )
+		{
+			penX = 0;
+			penY += rowHeight + 1;
+			rowHeight = 0;
+		}
+
+		mGlyphClips[ i ].x = penX;
+		mGlyphClips[ i ].y = penY;
+		mGlyphClips[ i ].w = w;
+		mGlyphClips[ i ].h = h;
+
+		penX += w + 1;
+		if( h > rowHeight )
+		{
+			rowHeight = h;
+		}
+	}
+
+	//Copy the glyphs into one surface
+	SDL_Surface* atlasSurface = NULL;
+	if( success )
+	{
+		atlasSurface = SDL_CreateRGBSurfaceWithFormat( 0, ATLAS_WIDTH, penY + rowHeight, 32, SDL_PIXELFORMAT_ARGB8888 );
+		if( atlasSurface == NULL )
+		{
+			printf( "Unable to create glyph atlas surface! SDL Error: %s\n", SDL_GetError() );
+			success = false;
+		}
+		else
+		{
+			SDL_FillRect( atlasSurface, NULL, SDL_MapRGBA( atlasSurface->format, 0, 0, 0, 0 ) );
+			for( int i = 0; i < GLYPH_COUNT; ++i )
+			{
+				if( glyphSurfaces[ i ] != NULL )
+				{
+					//Copy the coverage as is instead of blending it onto the empty atlas
+					SDL_SetSurfaceBlendMode( glyphSurfaces[ i ], SDL_BLENDMODE_NONE );
+					SDL_BlitSurface( glyphSurfaces[ i ], NULL, atlasSurface, &mGlyphClips[ i ] );
+				}
+			}
+		}
+	}
+
+	//Get rid of the glyph surfaces
+	for( int i = 0; i < GLYPH_COUNT; ++i )
+	{
+		if( glyphSurfaces[ i ] != NULL )
+		{
+			SDL_FreeSurface( glyphSurfaces[ i ] );
+		}
+	}
+
+	//Create texture from atlas pixels
+	if( atlasSurface != NULL )
+	{
+		mTexture = SDL_CreateTextureFromSurface( mRenderer, atlasSurface );
+		if( mTexture == NULL )
+		{
+			printf( "Unable to create texture from glyph atlas! SDL Error: %s\n", SDL_GetError() );
+		}
+		else
+		{
+			SDL_SetTextureBlendMode( mTexture, SDL_BLENDMODE_BLEND );
+			mWidth = atlasSurface->w;
+			mHeight = atlasSurface->h;
+		}
+
+		SDL_FreeSurface( atlasSurface );
+	}
+
+	//Return success
+	return mTexture != NULL;
+}
+
+void LGlyphAtlas::free()
+{
+	//Free texture if it exists
+	if( mTexture != NULL )
+	{
+		SDL_DestroyTexture( mTexture );
+		mTexture = NULL;
+		mWidth = 0;
+		mHeight = 0;
+	}
+}
+
+void LGlyphAtlas::render( int x, int y, const char* text, SDL_Color color )
+{
+	if( mTexture == NULL )
+	{
+		return;
+	}
+
+	//Keep the buffers' capacity so steady state drawing doesn't allocate
+	mVertices.clear();
+	mIndices.clear();
+
+	float penX = x;
+	for( const char* c = text; *c != '\0'; ++c )
+	{
+		int i = (unsigned char)*c - FIRST_GLYPH;
+		if( i < 0 || i >= GLYPH_COUNT )
+		{
+			continue;
+		}
+
+		SDL_Rect& clip = mGlyphClips[ i ];
+		if( clip.w > 0 && clip.h > 0 )
+		{
+			//Texture coordinates of the glyph
+			float u0 = (float)clip.x / mWidth;
+			float v0 = (float)clip.y / mHeight;
+			float u1 = (float)( clip.x + clip.w ) / mWidth;
+			float v1 = (float)( clip.y + clip.h ) / mHeight;
+
+			//Corners of the quad
+			float x0 = penX;
+			float y0 = y;
+			float x1 = penX + clip.w;
+			float y1 = y + clip.h;
+
+			int base = mVertices.size();
+			SDL_Vertex v;
+			v.color = color;
+			v.position.x = x0; v.position.y = y0; v.tex_coord.x = u0; v.tex_coord.y = v0; mVertices.push_back( v );
+			v.position.x = x1; v.position.y = y0; v.tex_coord.x = u1; v.tex_coord.y = v0; mVertices.push_back( v );
+			v.position.x = x1; v.position.y = y1; v.tex_coord.x = u1; v.tex_coord.y = v1; mVertices.push_back( v );
+			v.position.x = x0; v.position.y = y1; v.tex_coord.x = u0; v.tex_coord.y = v1; mVertices.push_back( v );
+
+			//Two triangles per glyph
+			mIndices.push_back( base );
+			mIndices.push_back( base + 1 );
+			mIndices.push_back( base + 2 );
+			mIndices.push_back( base );
+			mIndices.push_back( base + 2 );
+			mIndices.push_back( base + 3 );
+		}
+
+		penX += mGlyphAdvance[ i ];
+	}
+
+	//Render the whole string in one call
+	if( !mIndices.empty() )
+	{
+		SDL_RenderGeometry( mRenderer, mTexture, &mVertices[ 0 ], mVertices.size(), &mIndices[ 0 ], mIndices.size() );
+	}
+}
+
+void LGlyphAtlas::render( int x, int y, const std::string& text, SDL_Color color )
+{
+	render( x, y, text.c_str(), color );
+}
+
+int LGlyphAtlas::getTextWidth( const char* text )
+{
+	//Sum the pen advances of the string
+	int width = 0;
+	for( const char* c = text; *c != '\0'; ++c )
+	{
+		int i = (unsigned char)*c - FIRST_GLYPH;
+		if( i >= 0 && i < GLYPH_COUNT )
+		{
+			width += mGlyphAdvance[ i ];
+		}
+	}
+
+	return width;
+}
+
+int LGlyphAtlas::getTextWidth( const std::string& text )
+{
+	return getTextWidth( text.c_str() );
+}
+
+int LGlyphAtlas::getHeight()
+{
+	return mLineHeight;
+}
@@ -0,0 +1,215 @@
+//High resolution application timer
+//Same clock actions as LTimer, but built on the performance counter and kept
+//in 64 bits so it resolves sub-millisecond phases and never wraps. Times are
+//stored as raw counter ticks and only converted to nanoseconds when read
+class LHiResTimer
+{
+	public:
+		//Initializes variables
+		LHiResTimer();
+
+		//The various clock actions
+		void start();
+		void stop();
+		void pause();
+		void unpause();
+
+		//Gets the timer's time in nanoseconds
+		Uint64 getNanoseconds();
+
+		//Gets the timer's time in milliseconds
+		Uint64 getTicks();
+
+		//Gets the time since the previous lap, or start, and begins a new lap
+		Uint64 lap();
+
+		//Gets the time since start without ending the current lap
+		Uint64 split();
+
+		//Gets the number of laps taken since start
+		int getLapCount();
+
+		//Checks the status of the timer
+		bool isStarted();
+		bool isPaused();
+
+		//Converts performance counter ticks to nanoseconds
+		static Uint64 toNanoseconds( Uint64 counterTicks );
+
+	private:
+		//Gets the timer's time in counter ticks
+		Uint64 getCounterTicks();
+
+		//The counter value when the timer started
+		Uint64 mStartCounter;
+
+		//The counter ticks stored when the timer was paused
+		Uint64 mPausedCounter;
+
+		//The timer's time when the current lap began
+		Uint64 mLapCounter;
+		int mLapCount;
+
+		//The timer status
+		bool mPaused;
+		bool mStarted;
+};
+
+LHiResTimer::LHiResTimer()
+{
+	//Initialize the variables
+	mStartCounter = 0;
+	mPausedCounter = 0;
+	mLapCounter = 0;
+	mLapCount = 0;
+
+	mPaused = false;
+	mStarted = false;
+}
+
+void LHiResTimer::start()
+{
+	//Start the timer
+	mStarted = true;
+
+	//Unpause the timer
+	mPaused = false;
+
+	//Get the current clock time
+	mStartCounter = SDL_GetPerformanceCounter();
+	mPausedCounter = 0;
+
+	//Begin the first lap
+	mLapCounter = 0;
+	mLapCount = 0;
+}
+
+void LHiResTimer::stop()
+{
+	//Stop the timer
+	mStarted = false;
+
+	//Unpause the timer
+	mPaused = false;
+
+	//Clear tick variables
+	mStartCounter = 0;
+	mPausedCounter = 0;
+	mLapCounter = 0;
+	mLapCount = 0;
+}
+
+void LHiResTimer::pause()
+{
+	//If the timer is running and isn't already paused
+	if( mStarted && !mPaused )
+	{
+		//Pause the timer
+		mPaused = true;
+
+		//Calculate the paused ticks
+		mPausedCounter = SDL_GetPerformanceCounter() - mStartCounter;
+		mStartCounter = 0;
+	}
+}
+
+void LHiResTimer::unpause()
+{
+	//If the timer is running and paused
+	if( mStarted && mPaused )
+	{
+		//Unpause the timer
+		mPaused = false;
+
+		//Reset the starting ticks
+		mStartCounter = SDL_GetPerformanceCounter() - mPausedCounter;
+
+		//Reset the paused ticks
+		mPausedCounter = 0;
+	}
+}
+
+Uint64 LHiResTimer::getNanoseconds()
+{
+	return toNanoseconds( getCounterTicks() );
+}
+
+Uint64 LHiResTimer::getTicks()
+{
+	return getNanoseconds() / 1000000;
+}
+
+Uint64 LHiResTimer::lap()
+{
+	//Time from the start of this lap to now, which starts the next one
+	Uint64 now = getCounterTicks();
+	Uint64 lapTime = now - mLapCounter;
+	mLapCounter = now;
+	if( mStarted )
+	{
+		++mLapCount;
+	}
+
+	return toNanoseconds( lapTime );
+}
+
+Uint64 LHiResTimer::split()
+{
+	return getNanoseconds();
+}
+
+int LHiResTimer::getLapCount()
+{
+	return mLapCount;
+}
+
+bool LHiResTimer::isStarted()
+{
+	//Timer is running and paused or unpaused
+	return mStarted;
+}
+
+bool LHiResTimer::isPaused()
+{
+	//Timer is running and paused
+	return mPaused && mStarted;
+}
+
+Uint64 LHiResTimer::toNanoseconds( Uint64 counterTicks )
+{
+	//The frequency never changes while running
+	static const Uint64 frequency = SDL_GetPerformanceFrequency();
+
+	//Most platforms count nanoseconds already
+	if( frequency == 1000000000 )
+	{
+		return counterTicks;
+	}
+
+	//Split whole seconds off so the multiplication can't overflow
+	return counterTicks / frequency * 1000000000 + counterTicks % frequency * 1000000000 / frequency;
+}
+
+Uint64 LHiResTimer::getCounterTicks()
+{
+	//The actual timer time
+	Uint64 time = 0;
+
+	//If the timer is running
+	if( mStarted )
+	{
+		//If the timer is paused
+		if( mPaused )
+		{
+			//Return the number of ticks when the timer was paused
+			time = mPausedCounter;
+		}
+		else
+		{
+			//Return the current time minus the start time
+			time = SDL_GetPerformanceCounter() - mStartCounter;
+		}
+	}
+
+	return time;
+}
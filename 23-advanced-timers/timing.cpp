@@ -3,9 +3,11 @@
 #include <SDL2/SDL_ttf.h>
 #include <stdio.h>
 #include <string>
-#include <sstream>
+#include <vector>
 #include "LTexture.hpp"
+#include "LGlyphAtlas.hpp"
 #include "LTimer.hpp"
+#include "LHiResTimer.hpp"
 
 //Screen dimension constants
 const int SCREEN_WIDTH = 640;
@@ -28,7 +30,9 @@ SDL_Renderer* gRenderer = NULL;
 
 //Textures
 LTexture gPromptTextTexture;
-LTexture gTimeTextTexture;
+
+//Glyphs for the per-frame text
+LGlyphAtlas gGlyphAtlas;
 
 //Fonts
 TTF_Font* gFont = NULL;
@@ -118,6 +122,13 @@ bool loadMedia()
 			printf( "Unable to render prompt texture!\n" );
 			success = false;
 		}
+
+		//Load glyph atlas
+		if( !gGlyphAtlas.loadFromFont( gRenderer, gFont ) )
+		{
+			printf( "Unable to create glyph atlas!\n" );
+			success = false;
+		}
 	}
 
 	return success;
@@ -127,6 +138,7 @@ void close()
 {
 	//Free loaded images
 	gPromptTextTexture.free();
+	gGlyphAtlas.free();
 
 	//Destroy window	
 	SDL_DestroyRenderer( gRenderer );
@@ -166,10 +178,14 @@ int main( int argc, char* args[] )
 			SDL_Color textColor = { 0, 0, 0, 255 };
 
 			//The application timer
-			LTimer timer;
+			LHiResTimer timer;
+
+			//The most recent lap time in nanoseconds
+			Uint64 lastLap = 0;
 
-			//In memory text stream
-			std::stringstream timeText;
+			//In memory text buffers
+			char timeText[ 64 ];
+			char lapText[ 64 ];
 
 			//While application is running
 			while( !quit )
@@ -208,18 +224,17 @@ int main( int argc, char* args[] )
 								timer.pause();
 							}
 						}
+						//Lap
+						else if( e.key.keysym.sym == SDLK_l )
+						{
+							lastLap = timer.lap();
+						}
 					}
 				}
 
 				//Set text to be rendered
-				timeText.str( "" );
-				timeText << "Seconds since start time " << ( timer.getTicks() / 1000.f );
-
-				//Render text
-				if( !gTimeTextTexture.loadFromRenderedText( gRenderer, timeText.str().c_str(), gFont, textColor ) )
-				{
-					printf( "Unable to render time texture!\n" );
-				}
+				snprintf( timeText, sizeof( timeText ), "Seconds since start time %.6f", timer.getNanoseconds() / 1e9 );
+				snprintf( lapText, sizeof( lapText ), "Lap %d %.6f", timer.getLapCount(), lastLap / 1e9 );
 
 				//Clear screen
 				SDL_SetRenderDrawColor( gRenderer, 0x5F, 0x5F, 0x5F, 0xFF );
@@ -227,7 +242,8 @@ int main( int argc, char* args[] )
 
 				//Render current texture
 				gPromptTextTexture.render( gRenderer, ( SCREEN_WIDTH - gPromptTextTexture.getWidth() ) / 2, 0 );
-				gTimeTextTexture.render( gRenderer, ( SCREEN_WIDTH - gPromptTextTexture.getWidth() ) / 2, ( SCREEN_HEIGHT - gPromptTextTexture.getHeight() ) / 2 );
+				gGlyphAtlas.render( ( SCREEN_WIDTH - gPromptTextTexture.getWidth() ) / 2, ( SCREEN_HEIGHT - gPromptTextTexture.getHeight() ) / 2, timeText, textColor );
+				gGlyphAtlas.render( ( SCREEN_WIDTH - gPromptTextTexture.getWidth() ) / 2, ( SCREEN_HEIGHT - gPromptTextTexture.getHeight() ) / 2 + gGlyphAtlas.getHeight(), lapText, textColor );
 
 				//Update screen
 				SDL_RenderPresent( gRenderer );
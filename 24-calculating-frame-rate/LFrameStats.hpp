@@ -0,0 +1,192 @@
+//Per-frame timing statistics
+//Frame durations go into a fixed size ring that the main thread writes
+//without locking. Another thread can read it at any time: the ring position
+//is published atomically after each duration is stored, so a reader sees
+//every frame up to it, though the oldest few may already be overwritten
+class LFrameStats
+{
+	public:
+		//Initializes variables, the window is rounded up to a power of two
+		LFrameStats( Uint64 budgetNanoseconds, int window = 1024 );
+
+		//Records one frame's duration
+		void addFrame( Uint64 nanoseconds );
+
+		//Recomputes the percentiles over the frames in the window
+		void update();
+
+		//Gets the frame time in nanoseconds that p percent of the window is at or below
+		Uint64 getPercentile( int p );
+
+		//Gets the rolling statistics from the last update in nanoseconds
+		Uint64 getP50();
+		Uint64 getP95();
+		Uint64 getP99();
+		Uint64 getMax();
+
+		//Gets the frames recorded and how many of them took longer than the budget
+		Uint64 getFrameCount();
+		Uint64 getOverBudget();
+
+		//Writes the frames in the window to a CSV file
+		bool writeCsv( std::string path );
+
+	private:
+		//Copies the frames in the window, oldest first
+		void snapshot( std::vector<Uint64>& frames );
+
+		//Frame durations, indexed by frame number masked to the window
+		std::vector<Uint64> mFrames;
+		Uint64 mMask;
+
+		//Ring position published to readers after each store: the frame count
+		//until the ring fills, then the window size plus the next slot
+		SDL_atomic_t mPosition;
+		Uint64 mFrameCount;
+
+		//Frame budget and frames over it
+		Uint64 mBudget;
+		Uint64 mOverBudget;
+
+		//Statistics from the last update and the buffer used to compute them
+		std::vector<Uint64> mSorted;
+		Uint64 mP50, mP95, mP99, mMax;
+};
+
+LFrameStats::LFrameStats( Uint64 budgetNanoseconds, int window )
+{
+	//Round the window up so wrapping is a mask
+	int size = 1;
+	while( size < window )
+	{
+		size *= 2;
+	}
+	mFrames.resize( size, 0 );
+	mMask = size - 1;
+
+	//Initialize
+	SDL_AtomicSet( &mPosition, 0 );
+	mFrameCount = 0;
+	mBudget = budgetNanoseconds;
+	mOverBudget = 0;
+	mP50 = mP95 = mP99 = mMax = 0;
+}
+
+void LFrameStats::addFrame( Uint64 nanoseconds )
+{
+	mFrames[ mFrameCount & mMask ] = nanoseconds;
+	++mFrameCount;
+
+	if( nanoseconds > mBudget )
+	{
+		++mOverBudget;
+	}
+
+	//Make the duration visible before the position that covers it
+	Uint64 size = mFrames.size();
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet( &mPosition, (int)( mFrameCount < size ? mFrameCount : size + ( mFrameCount & mMask ) ) );
+}
+
+void LFrameStats::update()
+{
+	snapshot( mSorted );
+	if( mSorted.empty() )
+	{
+		return;
+	}
+
+	//Partial sorts, each percentile only needs everything below it on its left
+	std::vector<Uint64>::iterator first = mSorted.begin();
+	size_t last = mSorted.size() - 1;
+	size_t i99 = last * 99 / 100, i95 = last * 95 / 100, i50 = last / 2;
+	std::nth_element( first, first + i99, mSorted.end() );
+	std::nth_element( first, first + i95, first + i99 );
+	std::nth_element( first, first + i50, first + i95 );
+	mP99 = mSorted[ i99 ];
+	mP95 = mSorted[ i95 ];
+	mP50 = mSorted[ i50 ];
+	mMax = *std::max_element( first + i99, mSorted.end() );
+}
+
+Uint64 LFrameStats::getPercentile( int p )
+{
+	snapshot( mSorted );
+	if( mSorted.empty() )
+	{
+		return 0;
+	}
+
+	p = p < 0 ? 0 : p > 100 ? 100 : p;
+	size_t index = ( mSorted.size() - 1 ) * p / 100;
+	std::nth_element( mSorted.begin(), mSorted.begin() + index, mSorted.end() );
+	return mSorted[ index ];
+}
+
+Uint64 LFrameStats::getP50()
+{
+	return mP50;
+}
+
+Uint64 LFrameStats::getP95()
+{
+	return mP95;
+}
+
+Uint64 LFrameStats::getP99()
+{
+	return mP99;
+}
+
+Uint64 LFrameStats::getMax()
+{
+	return mMax;
+}
+
+Uint64 LFrameStats::getFrameCount()
+{
+	return mFrameCount;
+}
+
+Uint64 LFrameStats::getOverBudget()
+{
+	return mOverBudget;
+}
+
+bool LFrameStats::writeCsv( std::string path )
+{
+	FILE* file = fopen( path.c_str(), "w" );
+	if( file == NULL )
+	{
+		printf( "Unable to write frame times to %s!\n", path.c_str() );
+		return false;
+	}
+
+	//One row per frame, numbered from the start of the run
+	std::vector<Uint64> frames;
+	snapshot( frames );
+	Uint64 firstFrame = mFrameCount - frames.size();
+	fprintf( file, "frame,milliseconds,over_budget\n" );
+	for( size_t i = 0; i < frames.size(); ++i )
+	{
+		fprintf( file, "%llu,%.4f,%d\n", (unsigned long long)( firstFrame + i ), frames[ i ] / 1e6, frames[ i ] > mBudget ? 1 : 0 );
+	}
+
+	return fclose( file ) == 0;
+}
+
+void LFrameStats::snapshot( std::vector<Uint64>& frames )
+{
+	//Read the published position, then the durations it covers
+	Uint64 position = SDL_AtomicGet( &mPosition );
+	SDL_MemoryBarrierAcquire();
+
+	//The oldest frame sits just after the newest once the ring is full
+	Uint64 size = position < mFrames.size() ? position : mFrames.size();
+	Uint64 next = position & mMask;
+	frames.resize( size );
+	for( Uint64 i = 0; i < size; ++i )
+	{
+		frames[ i ] = mFrames[ ( next - size + i ) & mMask ];
+	}
+}
@@ -3,14 +3,21 @@
 #include <SDL2/SDL_ttf.h>
 #include <stdio.h>
 #include <string>
-#include <sstream>
+#include <vector>
+#include <algorithm>
 #include "LTexture.hpp"
+#include "LGlyphAtlas.hpp"
 #include "LTimer.hpp"
+#include "LHiResTimer.hpp"
+#include "LFrameStats.hpp"
 
 //Screen dimension constants
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
 
+//Refresh rate assumed when the display doesn't report one
+const int DEFAULT_REFRESH_RATE = 60;
+
 //Starts up SDL and creates window
 bool init();
 
@@ -20,6 +27,9 @@ bool loadMedia();
 //Frees media and shuts down SDL
 void close();
 
+//Gets the frame time that means a vblank was missed, in nanoseconds
+Uint64 getFrameBudget();
+
 //The window we'll be rendering to
 SDL_Window* gWindow = NULL;
 
@@ -28,7 +38,9 @@ SDL_Renderer* gRenderer = NULL;
 
 //Textures
 LTexture gPromptTextTexture;
-LTexture gFPSTextTexture;
+
+//Glyphs for the per-frame text
+LGlyphAtlas gGlyphAtlas;
 
 //Fonts
 TTF_Font* gFont = NULL;
@@ -118,6 +130,13 @@ bool loadMedia()
 			printf( "Unable to render prompt texture!\n" );
 			success = false;
 		}
+
+		//Load glyph atlas
+		if( !gGlyphAtlas.loadFromFont( gRenderer, gFont ) )
+		{
+			printf( "Unable to create glyph atlas!\n" );
+			success = false;
+		}
 	}
 
 	return success;
@@ -127,6 +146,7 @@ void close()
 {
 	//Free loaded images
 	gPromptTextTexture.free();
+	gGlyphAtlas.free();
 
 	//Destroy window	
 	SDL_DestroyRenderer( gRenderer );
@@ -140,6 +160,24 @@ void close()
 }
 
 
+Uint64 getFrameBudget()
+{
+	//Presents wait for vsync, so frames are one refresh period give or take some jitter
+	int refreshRate = DEFAULT_REFRESH_RATE;
+	SDL_DisplayMode mode;
+	if( SDL_GetWindowDisplayMode( gWindow, &mode ) == 0 && mode.refresh_rate > 0 )
+	{
+		refreshRate = mode.refresh_rate;
+	}
+	else
+	{
+		printf( "Warning: Refresh rate unknown, assuming %d Hz!\n", DEFAULT_REFRESH_RATE );
+	}
+
+	//Only a frame that ran past the next vblank as well is a stutter
+	return 1000000000ull * 3 / ( 2 * refreshRate );
+}
+
 int main( int argc, char* args[] )
 {
 	//Start up SDL and create window
@@ -165,15 +203,18 @@ int main( int argc, char* args[] )
 			//Set text color as black
 			SDL_Color textColor = { 0, 0, 0, 255 };
 
-			//The application timer
-			LTimer fpsTimer;
+			//The frame timer, each lap is one frame
+			LHiResTimer frameTimer;
+
+			//Frame time statistics over the last 1024 frames
+			LFrameStats frameStats( getFrameBudget() );
 
-			//In memory text stream
-			std::stringstream timeText;
+			//In memory text buffers
+			char timeText[ 64 ];
+			char budgetText[ 64 ];
 
-			/* start counting frames per second */
-			int countedFrames = 0;
-			fpsTimer.start();
+			/* start timing frames */
+			frameTimer.start();
 
 			//While application is running
 			while( !quit )
@@ -185,32 +226,30 @@ int main( int argc, char* args[] )
 					if( e.type == SDL_QUIT )
 						quit = true;
 				}
-				/* calculate and correct fps */
-				float avgFPS = countedFrames / (fpsTimer.getTicks() / 1000.f);
-				if (avgFPS > 2000000)
-					avgFPS = 0;
-
-				/* set text to be rendered */
-				timeText.str("");
-				timeText << "Average Frames Per Second " << avgFPS;
-
-				/* render text */
-				if (!gFPSTextTexture.loadFromRenderedText(gRenderer, timeText.str(), gFont, textColor))
-				{
-					perror("Unable to render FPS texture!\n");
-				}
+				/* set text to be rendered from the frames so far */
+				frameStats.update();
+				snprintf(timeText, sizeof(timeText), "p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms", frameStats.getP50() / 1e6, frameStats.getP95() / 1e6, frameStats.getP99() / 1e6, frameStats.getMax() / 1e6);
+				snprintf(budgetText, sizeof(budgetText), "%llu of %llu frames over budget", (unsigned long long)frameStats.getOverBudget(), (unsigned long long)frameStats.getFrameCount());
 
 				//Clear screen
 				SDL_SetRenderDrawColor( gRenderer, 0x5F, 0x5F, 0x5F, 0xFF );
 				SDL_RenderClear( gRenderer );
 
 				/* render textures */
-				gFPSTextTexture.render(gRenderer, (SCREEN_WIDTH - gFPSTextTexture.getWidth()) / 2, (SCREEN_HEIGHT - gFPSTextTexture.getHeight()) / 2);
+				gGlyphAtlas.render((SCREEN_WIDTH - gGlyphAtlas.getTextWidth(timeText)) / 2, (SCREEN_HEIGHT - gGlyphAtlas.getHeight()) / 2, timeText, textColor);
+				gGlyphAtlas.render((SCREEN_WIDTH - gGlyphAtlas.getTextWidth(budgetText)) / 2, (SCREEN_HEIGHT + gGlyphAtlas.getHeight()) / 2, budgetText, textColor);
 
 				//Update screen
 				SDL_RenderPresent( gRenderer );
-				++countedFrames;
+
+				/* the frame ends once it is presented */
+				frameStats.addFrame(frameTimer.lap());
 			}
+
+			/* keep the run's frame times for later analysis */
+			frameStats.update();
+			printf("%llu frames, p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms, %llu over budget\n", (unsigned long long)frameStats.getFrameCount(), frameStats.getP50() / 1e6, frameStats.getP95() / 1e6, frameStats.getP99() / 1e6, frameStats.getMax() / 1e6, (unsigned long long)frameStats.getOverBudget());
+			frameStats.writeCsv("frametimes.csv");
 		}
 	}
 
@@ -3,15 +3,17 @@
 #include <SDL2/SDL_ttf.h>
 #include <stdio.h>
 #include <string>
-#include <sstream>
+#include <vector>
 #include "LTexture.hpp"
+#include "LGlyphAtlas.hpp"
 #include "LTimer.hpp"
+#include "LHiResTimer.hpp"
+#include "LFramePacer.hpp"
 
 //Screen dimension constants
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
 const int SCREEN_FPS = 24;
-const int SCREEN_TICKS_PER_FRAME = 1000 / SCREEN_FPS;
 
 //Starts up SDL and creates window
 bool init();
@@ -30,7 +32,9 @@ SDL_Renderer* gRenderer = NULL;
 
 //Textures
 LTexture gPromptTextTexture;
-LTexture gFPSTextTexture;
+
+//Glyphs for the per-frame FPS text
+LGlyphAtlas gGlyphAtlas;
 
 //Fonts
 TTF_Font* gFont = NULL;
@@ -120,6 +124,13 @@ bool loadMedia()
 			printf( "Unable to render prompt texture!\n" );
 			success = false;
 		}
+
+		//Load glyph atlas
+		if( !gGlyphAtlas.loadFromFont( gRenderer, gFont ) )
+		{
+			printf( "Unable to create glyph atlas!\n" );
+			success = false;
+		}
 	}
 
 	return success;
@@ -129,6 +140,7 @@ void close()
 {
 	//Free loaded images
 	gPromptTextTexture.free();
+	gGlyphAtlas.free();
 
 	//Destroy window	
 	SDL_DestroyRenderer( gRenderer );
@@ -168,24 +180,23 @@ int main( int argc, char* args[] )
 			SDL_Color textColor = { 0, 0, 0, 255 };
 
 			//The application timer
-			LTimer fpsTimer;
+			LHiResTimer fpsTimer;
 
-			//The frames per second cap timer
-			LTimer capTimer;
+			//The frames per second cap
+			LFramePacer pacer( SCREEN_FPS );
 
-			//In memory text stream
-			std::stringstream timeText;
+			//In memory text buffers
+			char timeText[ 64 ];
+			char pacingText[ 64 ];
 
 			/* start counting frames per second */
 			int countedFrames = 0;
 			fpsTimer.start();
+			pacer.start();
 
 			//While application is running
 			while( !quit )
 			{
-				//Start cap timer
-				capTimer.start();
-
 				//Handle events on queue
 				while( SDL_PollEvent( &e ) != 0 )
 				{
@@ -195,38 +206,28 @@ int main( int argc, char* args[] )
 				}
 
 				/* calculate and correct fps */
-				float avgFPS = countedFrames / (fpsTimer.getTicks() / 1000.f);
+				float avgFPS = countedFrames / (fpsTimer.getNanoseconds() / 1e9f);
 				if (avgFPS > 2000000)
 					avgFPS = 0;
 
 				/* set text to be rendered */
-				timeText.str("");
-				timeText << "Average Frames Per Second (With Cap)" << avgFPS;
-
-				/* render text */
-				if (!gFPSTextTexture.loadFromRenderedText(gRenderer, timeText.str(), gFont, textColor))
-				{
-					perror("Unable to render FPS texture!\n");
-				}
+				snprintf(timeText, sizeof(timeText), "Average Frames Per Second (With Cap)%g", avgFPS);
+				snprintf(pacingText, sizeof(pacingText), "Pacing error %.3f ms, jitter %.3f ms, max %.3f ms", pacer.getMeanError() / 1e6, pacer.getJitter() / 1e6, pacer.getMaxError() / 1e6);
 
 				//Clear screen
 				SDL_SetRenderDrawColor( gRenderer, 0x5F, 0x5F, 0x5F, 0xFF );
 				SDL_RenderClear( gRenderer );
 
 				/* render textures */
-				gFPSTextTexture.render(gRenderer, (SCREEN_WIDTH - gFPSTextTexture.getWidth()) / 2, (SCREEN_HEIGHT - gFPSTextTexture.getHeight()) / 2);
+				gGlyphAtlas.render((SCREEN_WIDTH - gGlyphAtlas.getTextWidth(timeText)) / 2, (SCREEN_HEIGHT - gGlyphAtlas.getHeight()) / 2, timeText, textColor);
+				gGlyphAtlas.render((SCREEN_WIDTH - gGlyphAtlas.getTextWidth(pacingText)) / 2, (SCREEN_HEIGHT + gGlyphAtlas.getHeight()) / 2, pacingText, textColor);
 
 				//Update screen
 				SDL_RenderPresent( gRenderer );
 				++countedFrames;
 
-				//If frame finished early
-				int frameTicks = capTimer.getTicks();
-				if (frameTicks < SCREEN_TICKS_PER_FRAME)
-				{
-					//wait remaining time
-					SDL_Delay(SCREEN_TICKS_PER_FRAME - frameTicks);
-				}
+				/* wait for the next frame's deadline */
+				pacer.wait();
 			}
 		}
 	}
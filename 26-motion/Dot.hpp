@@ -6,8 +6,8 @@ class Dot
 		static const int DOT_WIDTH = 20;
 		static const int DOT_HEIGHT = 20;
 
-		/* maximum axis velocity of the dot */
-		static const int DOT_VEL = 10;
+		/* maximum axis velocity of the dot in pixels per second */
+		static const int DOT_VEL = 600;
 
 		/* initializes the variables */
 		Dot(int screen_height, int screen_width);
@@ -15,18 +15,21 @@ class Dot
 		/* takes key presses and adjusts the dot's velocity */
 		void handleEvent(SDL_Event& e);
 
-		/* moves the dot */
-		void move();
+		/* moves the dot by one time step of dt seconds */
+		void move(float dt);
 
-		/* shows the dot on the screen */
-		void render(LTexture *tex);
+		/* shows the dot on the screen, alpha blends between the last two steps */
+		void render(LTexture *tex, float alpha = 1.0f);
 
 	private:
 		/* the screen height and width */
 		int sh, sw;
 
 		/* the X and Y offsets of the dot */
-		int mPosX, mPosY;
+		float mPosX, mPosY;
+
+		/* the offsets before the last step, for interpolation */
+		float mPrevX, mPrevY;
 
 		/* the velocity of the dot */
 		int mVelX, mVelY;
@@ -41,6 +44,8 @@ Dot::Dot(int screen_height, int screen_width)
 	/* initializes the offsets */
 	mPosX = 0;
 	mPosY = 0;
+	mPrevX = 0;
+	mPrevY = 0;
 
 	/* initialize the velocity */
 	mVelX = 0;
@@ -70,29 +75,43 @@ void Dot::handleEvent(SDL_Event& e)
 	}
 }
 
-void Dot::move()
+void Dot::move(float dt)
 {
+	PROFILE_SCOPE("Dot::move");
+
+	/* remember where the step started */
+	mPrevX = mPosX;
+	mPrevY = mPosY;
+
 	/* move the dot left or right */
-	mPosX += mVelX;
+	mPosX += mVelX * dt;
 
 	/* if the dot went too far to the left or right */
-	if ((mPosX < 0) || (mPosX + DOT_WIDTH > sw)) {
-		/* move back */
-		mPosX -= mVelX;
+	if (mPosX < 0) {
+		/* stop at the edge */
+		mPosX = 0;
+	}
+	else if (mPosX + DOT_WIDTH > sw) {
+		mPosX = sw - DOT_WIDTH;
 	}
 
 	/* move the dot up or down */
-	mPosY += mVelY;
+	mPosY += mVelY * dt;
 
 	/* if the dot went too far up or down */
-	if ((mPosY < 0) || (mPosY + DOT_HEIGHT > sh)) {
-		/* move back */
-		mPosY -= mVelY;
+	if (mPosY < 0) {
+		/* stop at the edge */
+		mPosY = 0;
+	}
+	else if (mPosY + DOT_HEIGHT > sh) {
+		mPosY = sh - DOT_HEIGHT;
 	}
 }
 
-void Dot::render(LTexture *tex)
+void Dot::render(LTexture *tex, float alpha)
 {
-	/* show the dot */
-	tex->render(mPosX, mPosY);
+	/* show the dot between where it was and where it is */
+	float x = mPrevX + (mPosX - mPrevX) * alpha;
+	float y = mPrevY + (mPosY - mPrevY) * alpha;
+	tex->render((int)(x + 0.5f), (int)(y + 0.5f));
 }
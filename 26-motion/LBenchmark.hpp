@@ -0,0 +1,322 @@
+//Headless benchmark mode for a lesson's main loop
+//When LESSON_BENCH_FRAMES is set the lesson renders with the software
+//renderer, feeds itself the key presses scripted in LESSON_BENCH_INPUT, quits
+//after the given number of frames and prints its timings as one JSON line.
+//The script is a comma separated list of frame:+Key or frame:-Key, with key
+//names as SDL_GetKeyFromName reads them, e.g. "0:+Right,60:-Right".
+//LESSON_BENCH_REPLAY names an input log to feed instead, frame by frame, and
+//also turns on benchmark mode, running as many frames as the log covers
+//unless LESSON_BENCH_FRAMES says otherwise. LESSON_BENCH_TRACE names a CSV
+//file to write every frame's time to. LESSON_RECORD_INPUT names a log to
+//record the input handled in any run to, benchmarked or not.
+//Without any of these every call does nothing
+class LBenchmark
+{
+	public:
+		//Simulated time per frame in benchmark mode
+		static const int FRAMES_PER_SECOND = 60;
+
+		//Initializes variables
+		LBenchmark();
+
+		//Reads the benchmark settings from the environment, call before SDL_Init
+		bool configure( std::string scene );
+
+		//Checks whether the lesson is being benchmarked
+		bool isEnabled();
+
+		//Marks the end of initialization and media loading
+		void markLoaded();
+
+		//Pushes this frame's scripted or replayed input, and a quit once every frame has run
+		void beginFrame();
+
+		//Records an event the main loop handled, if input is being recorded
+		void recordEvent( const SDL_Event& e );
+
+		//Records the time since the previous frame ended
+		void endFrame();
+
+		//Gets the fixed time a frame simulates so runs are deterministic
+		float getFrameSeconds();
+
+		//Prints the results as JSON to stdout, then writes the frame time trace and input recording if asked for
+		void report();
+
+	private:
+		//A scripted key press or release
+		struct Input
+		{
+			int frame;
+			SDL_Keycode key;
+			bool pressed;
+		};
+
+		//Parses the input script
+		void parseScript( std::string script );
+
+		//Orders inputs by frame
+		static bool inputBefore( const Input& a, const Input& b );
+
+		//Scene name and run length
+		std::string mScene;
+		bool mEnabled;
+		int mFrames;
+
+		//Scripted input ordered by frame and the next one due
+		std::vector<Input> mScript;
+		size_t mNextInput;
+
+		//Input log being played back
+		LInputLog mReplay;
+
+		//Input log being recorded and where it goes
+		LInputLog mRecording;
+		std::string mRecordPath;
+
+		//Where frame times are written
+		std::string mTracePath;
+
+		//Frames run so far, counted whether benchmarking or not
+		int mFrame;
+
+		//Performance counter at configure, after loading and at the last frame end
+		Uint64 mStartCounter;
+		Uint64 mLoadedCounter;
+		Uint64 mFrameCounter;
+
+		//Frame durations in counter ticks
+		std::vector<Uint64> mFrameTimes;
+};
+
+LBenchmark::LBenchmark()
+{
+	//Initialize
+	mEnabled = false;
+	mFrames = 0;
+	mNextInput = 0;
+	mFrame = 0;
+	mStartCounter = 0;
+	mLoadedCounter = 0;
+	mFrameCounter = 0;
+}
+
+bool LBenchmark::configure( std::string scene )
+{
+	//Recording works in live runs too
+	const char* record = SDL_getenv( "LESSON_RECORD_INPUT" );
+	if( record != NULL && record[ 0 ] != '\0' )
+	{
+		mRecordPath = record;
+	}
+
+	const char* frames = SDL_getenv( "LESSON_BENCH_FRAMES" );
+	const char* replay = SDL_getenv( "LESSON_BENCH_REPLAY" );
+	bool replaying = replay != NULL && replay[ 0 ] != '\0';
+	if( replaying && !mReplay.loadFromFile( replay ) )
+	{
+		printf( "Unable to replay %s, running without it\n", replay );
+		replaying = false;
+	}
+
+	if( ( frames == NULL || SDL_atoi( frames ) <= 0 ) && !replaying )
+	{
+		return false;
+	}
+
+	//A replay runs until its last event unless told how long to run
+	mScene = scene;
+	mEnabled = true;
+	mFrames = frames != NULL && SDL_atoi( frames ) > 0 ? SDL_atoi( frames ) : SDL_max( mReplay.getFrameCount(), 1 );
+	mFrameTimes.reserve( mFrames );
+
+	const char* trace = SDL_getenv( "LESSON_BENCH_TRACE" );
+	if( trace != NULL )
+	{
+		mTracePath = trace;
+	}
+
+	const char* script = SDL_getenv( "LESSON_BENCH_INPUT" );
+	if( script != NULL )
+	{
+		parseScript( script );
+	}
+
+	//Draw in software without waiting on a display unless told otherwise
+	SDL_SetHintWithPriority( SDL_HINT_RENDER_DRIVER, "software", SDL_HINT_DEFAULT );
+	SDL_SetHintWithPriority( SDL_HINT_RENDER_VSYNC, "0", SDL_HINT_OVERRIDE );
+
+	mStartCounter = SDL_GetPerformanceCounter();
+	return true;
+}
+
+bool LBenchmark::isEnabled()
+{
+	return mEnabled;
+}
+
+void LBenchmark::markLoaded()
+{
+	if( mEnabled )
+	{
+		mLoadedCounter = SDL_GetPerformanceCounter();
+		mFrameCounter = mLoadedCounter;
+	}
+}
+
+void LBenchmark::beginFrame()
+{
+	if( !mEnabled )
+	{
+		return;
+	}
+
+	int frame = mFrameTimes.size();
+
+	//Feed the input due this frame, logged input first
+	mReplay.replay( frame );
+	while( mNextInput < mScript.size() && mScript[ mNextInput ].frame <= frame )
+	{
+		Input& input = mScript[ mNextInput++ ];
+
+		SDL_Event e;
+		SDL_zero( e );
+		e.type = input.pressed ? SDL_KEYDOWN : SDL_KEYUP;
+		e.key.state = input.pressed ? SDL_PRESSED : SDL_RELEASED;
+		e.key.keysym.sym = input.key;
+		e.key.keysym.scancode = SDL_GetScancodeFromKey( input.key );
+		SDL_PushEvent( &e );
+	}
+
+	//End the run after the last frame
+	if( frame == mFrames - 1 )
+	{
+		SDL_Event e;
+		SDL_zero( e );
+		e.type = SDL_QUIT;
+		SDL_PushEvent( &e );
+	}
+}
+
+void LBenchmark::recordEvent( const SDL_Event& e )
+{
+	if( !mRecordPath.empty() )
+	{
+		mRecording.record( e, mFrame );
+	}
+}
+
+void LBenchmark::endFrame()
+{
+	++mFrame;
+
+	if( mEnabled )
+	{
+		Uint64 now = SDL_GetPerformanceCounter();
+		mFrameTimes.push_back( now - mFrameCounter );
+		mFrameCounter = now;
+	}
+}
+
+float LBenchmark::getFrameSeconds()
+{
+	return 1.0f / FRAMES_PER_SECOND;
+}
+
+void LBenchmark::report()
+{
+	//Save the recording even from a live run
+	if( !mRecordPath.empty() && mRecording.saveToFile( mRecordPath ) )
+	{
+		printf( "Recorded %d input events over %d frames to %s\n", mRecording.getEventCount(), mFrame, mRecordPath.c_str() );
+	}
+
+	if( !mEnabled )
+	{
+		return;
+	}
+
+	double toMs = 1000.0 / SDL_GetPerformanceFrequency();
+	double loadMs = ( mLoadedCounter - mStartCounter ) * toMs;
+	double runMs = ( mFrameCounter - mLoadedCounter ) * toMs;
+
+	//Frame time percentiles
+	std::vector<Uint64> sorted = mFrameTimes;
+	std::sort( sorted.begin(), sorted.end() );
+	double p50 = 0, p95 = 0, p99 = 0, max = 0;
+	if( !sorted.empty() )
+	{
+		size_t last = sorted.size() - 1;
+		p50 = sorted[ last / 2 ] * toMs;
+		p95 = sorted[ last * 95 / 100 ] * toMs;
+		p99 = sorted[ last * 99 / 100 ] * toMs;
+		max = sorted[ last ] * toMs;
+	}
+
+	const char* videoDriver = SDL_GetCurrentVideoDriver();
+	printf( "{\"scene\":\"%s\",\"video_driver\":\"%s\",\"frames\":%d,\"load_ms\":%.3f,\"run_ms\":%.3f,\"fps\":%.2f,"
+		"\"frame_ms\":{\"p50\":%.4f,\"p95\":%.4f,\"p99\":%.4f,\"max\":%.4f}}\n",
+		mScene.c_str(), videoDriver != NULL ? videoDriver : "none", (int)mFrameTimes.size(), loadMs, runMs,
+		runMs > 0 ? mFrameTimes.size() * 1000.0 / runMs : 0.0, p50, p95, p99, max );
+	fflush( stdout );
+
+	//One row per frame, so runs on the same input can be compared frame by frame
+	if( !mTracePath.empty() )
+	{
+		FILE* file = fopen( mTracePath.c_str(), "w" );
+		if( file == NULL )
+		{
+			printf( "Unable to write frame times to %s!\n", mTracePath.c_str() );
+			return;
+		}
+
+		fprintf( file, "frame,milliseconds\n" );
+		for( size_t i = 0; i < mFrameTimes.size(); ++i )
+		{
+			fprintf( file, "%d,%.4f\n", (int)i, mFrameTimes[ i ] * toMs );
+		}
+		fclose( file );
+	}
+}
+
+void LBenchmark::parseScript( std::string script )
+{
+	//Entries look like 12:+Right
+	size_t start = 0;
+	while( start < script.size() )
+	{
+		size_t end = script.find( ',', start );
+		if( end == std::string::npos )
+		{
+			end = script.size();
+		}
+
+		std::string entry = script.substr( start, end - start );
+		size_t colon = entry.find( ':' );
+		if( colon != std::string::npos && colon + 2 < entry.size() && ( entry[ colon + 1 ] == '+' || entry[ colon + 1 ] == '-' ) )
+		{
+			Input input;
+			input.frame = SDL_atoi( entry.substr( 0, colon ).c_str() );
+			input.pressed = entry[ colon + 1 ] == '+';
+			input.key = SDL_GetKeyFromName( entry.substr( colon + 2 ).c_str() );
+			if( input.key != SDLK_UNKNOWN )
+			{
+				mScript.push_back( input );
+			}
+			else
+			{
+				printf( "Unknown key in benchmark input: %s\n", entry.c_str() );
+			}
+		}
+
+		start = end + 1;
+	}
+
+	//Keep the script order for inputs on the same frame
+	std::stable_sort( mScript.begin(), mScript.end(), inputBefore );
+}
+
+bool LBenchmark::inputBefore( const Input& a, const Input& b )
+{
+	return a.frame < b.frame;
+}
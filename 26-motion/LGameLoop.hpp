@@ -0,0 +1,155 @@
+/*
+ * fixed timestep game loop
+ *
+ * the simulation advances in steps of exactly 1 / updateRate seconds no
+ * matter how fast frames are drawn, the time left over after the last step
+ * is handed to render as an interpolation factor between the previous and
+ * current state. time is accumulated in performance counter ticks so no
+ * rounding error builds up over a long run.
+ *
+ *	loop.beginFrame();
+ *	while (loop.step())
+ *		world.update(loop.getStep());
+ *	world.render(loop.getAlpha());
+ *
+ * getStepEnd tells a step which moment it simulates up to, so it can take
+ * exactly the input that arrived before then and leave the rest for later
+ * steps instead of applying a whole frame's input at the first one.
+ */
+class LGameLoop
+{
+	public:
+		/* initializes the variables, steps per second and the most steps run in one frame */
+		LGameLoop(double updateRate = 120.0, int maxSteps = 8);
+
+		/* restarts the clock, call once before the first frame */
+		void start();
+
+		/* adds the time since the last frame to the accumulator */
+		void beginFrame();
+
+		/* adds a fixed frame time instead of reading the clock, for deterministic runs */
+		void beginFrame(float seconds);
+
+		/* returns true while a fixed step is due this frame */
+		bool step();
+
+		/* gets the fixed step in seconds */
+		float getStep();
+
+		/* gets how far between the last two steps the current time is, 0 to 1 */
+		float getAlpha();
+
+		/* gets the performance counter time the current step simulates up to */
+		Uint64 getStepEnd();
+
+		/* gets the number of steps run so far */
+		Uint64 getStepCount();
+
+		/* gets the number of frames that fell behind and dropped time */
+		Uint64 getDroppedFrames();
+
+	private:
+		/* length of a step in counter ticks and seconds */
+		Uint64 mStepTicks;
+		float mStepSeconds;
+
+		/* spiral of death guard */
+		int mMaxSteps;
+
+		/* counter reading at the last frame and the time not yet simulated */
+		Uint64 mLastCounter;
+		Uint64 mAccumulator;
+
+		/* steps run this frame */
+		int mFrameSteps;
+
+		/* statistics */
+		Uint64 mStepCount;
+		Uint64 mDroppedFrames;
+};
+
+LGameLoop::LGameLoop(double updateRate, int maxSteps)
+{
+	mStepTicks = (Uint64)(SDL_GetPerformanceFrequency() / updateRate + 0.5);
+	if (mStepTicks == 0)
+		mStepTicks = 1;
+	mStepSeconds = (float)((double)mStepTicks / SDL_GetPerformanceFrequency());
+	mMaxSteps = maxSteps > 0 ? maxSteps : 1;
+
+	mLastCounter = SDL_GetPerformanceCounter();
+	mAccumulator = 0;
+	mFrameSteps = 0;
+	mStepCount = 0;
+	mDroppedFrames = 0;
+}
+
+void LGameLoop::start()
+{
+	mLastCounter = SDL_GetPerformanceCounter();
+	mAccumulator = 0;
+	mFrameSteps = 0;
+}
+
+void LGameLoop::beginFrame()
+{
+	Uint64 now = SDL_GetPerformanceCounter();
+	mAccumulator += now - mLastCounter;
+	mLastCounter = now;
+	mFrameSteps = 0;
+}
+
+void LGameLoop::beginFrame(float seconds)
+{
+	mAccumulator += (Uint64)(seconds * SDL_GetPerformanceFrequency() + 0.5);
+	mLastCounter = SDL_GetPerformanceCounter();
+	mFrameSteps = 0;
+}
+
+bool LGameLoop::step()
+{
+	if (mAccumulator < mStepTicks)
+		return false;
+
+	/*
+	 * a frame that needs more than mMaxSteps steps means updates cost more
+	 * than the time they simulate, catching up would only make the next
+	 * frame later, so drop the whole steps and keep the fraction
+	 */
+	if (mFrameSteps == mMaxSteps) {
+		mAccumulator %= mStepTicks;
+		++mDroppedFrames;
+		return false;
+	}
+
+	mAccumulator -= mStepTicks;
+	++mFrameSteps;
+	++mStepCount;
+	return true;
+}
+
+float LGameLoop::getStep()
+{
+	return mStepSeconds;
+}
+
+float LGameLoop::getAlpha()
+{
+	return (float)((double)mAccumulator / mStepTicks);
+}
+
+Uint64 LGameLoop::getStepEnd()
+{
+	/* whatever is still in the accumulator hasn't been simulated yet */
+	return mLastCounter - mAccumulator;
+}
+
+Uint64 LGameLoop::getStepCount()
+{
+	return mStepCount;
+}
+
+Uint64 LGameLoop::getDroppedFrames()
+{
+	return mDroppedFrames;
+}
@@ -0,0 +1,208 @@
+//Input event queue
+//Takes SDL's input events as SDL receives them, through its event filter,
+//and stamps each with the performance counter on arrival. They go into a ring
+//with one writer, the filter, and one reader, the main loop, so neither side
+//ever locks: each only moves its own end and publishes it with an atomic.
+//SDL runs the filter under its own lock, so even events pushed from other
+//threads come through one at a time. Input taken by the queue no longer
+//reaches SDL_PollEvent, read it from the queue instead. Every other event,
+//like the window's, stays in SDL's queue: SDL only shows events that pass
+//the filter to its event watchers, and the renderer watches window events
+
+//An event and when it arrived
+struct LInputEvent
+{
+	SDL_Event event;
+	Uint64 time;
+};
+
+class LInputQueue
+{
+	public:
+		//Events the ring holds, a power of two
+		static const int CAPACITY = 1024;
+
+		//Initializes variables
+		LInputQueue();
+
+		//Gives events back to SDL
+		~LInputQueue();
+
+		//Starts taking SDL's events
+		void start();
+
+		//Lets SDL's events go to its own queue again
+		void stop();
+
+		//Has SDL read waiting events from the system, which fills the queue
+		void pump();
+
+		//Takes the oldest event, false if there is none
+		bool pop( LInputEvent& event );
+
+		//Takes the oldest event if it arrived before the given counter time, so an update only sees input up to its own time
+		bool popBefore( Uint64 time, LInputEvent& event );
+
+		//Gets the number of events waiting
+		int getCount();
+
+		//Gets the number of events lost because the ring was full
+		int getDropped();
+
+	private:
+		//Event filter SDL calls with every event, userdata is the queue
+		static int SDLCALL filter( void* userdata, SDL_Event* event );
+
+		//Checks whether an event type is input the queue takes
+		static bool isQueued( Uint32 type );
+
+		//Adds an event, false if the ring is full
+		bool push( const SDL_Event& event, Uint64 time );
+
+		//The ring
+		LInputEvent mEvents[ CAPACITY ];
+
+		//Events written and read so far, only the filter moves the head and only the reader the tail
+		SDL_atomic_t mHead;
+		SDL_atomic_t mTail;
+
+		//Events lost to a full ring
+		SDL_atomic_t mDropped;
+
+		//Whether the filter is installed
+		bool mStarted;
+};
+
+LInputQueue::LInputQueue()
+{
+	//Initialize
+	SDL_AtomicSet( &mHead, 0 );
+	SDL_AtomicSet( &mTail, 0 );
+	SDL_AtomicSet( &mDropped, 0 );
+	mStarted = false;
+}
+
+LInputQueue::~LInputQueue()
+{
+	stop();
+}
+
+void LInputQueue::start()
+{
+	SDL_SetEventFilter( filter, this );
+	mStarted = true;
+}
+
+void LInputQueue::stop()
+{
+	if( mStarted )
+	{
+		SDL_SetEventFilter( NULL, NULL );
+		mStarted = false;
+	}
+}
+
+void LInputQueue::pump()
+{
+	SDL_PumpEvents();
+}
+
+bool LInputQueue::pop( LInputEvent& event )
+{
+	Uint32 tail = SDL_AtomicGet( &mTail );
+	if( tail == (Uint32)SDL_AtomicGet( &mHead ) )
+	{
+		return false;
+	}
+
+	//The event was written before the head moved past it
+	SDL_MemoryBarrierAcquire();
+	event = mEvents[ tail & ( CAPACITY - 1 ) ];
+
+	//Done reading before the slot is handed back
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet( &mTail, tail + 1 );
+	return true;
+}
+
+bool LInputQueue::popBefore( Uint64 time, LInputEvent& event )
+{
+	Uint32 tail = SDL_AtomicGet( &mTail );
+	if( tail == (Uint32)SDL_AtomicGet( &mHead ) )
+	{
+		return false;
+	}
+
+	SDL_MemoryBarrierAcquire();
+	if( mEvents[ tail & ( CAPACITY - 1 ) ].time >= time )
+	{
+		return false;
+	}
+
+	return pop( event );
+}
+
+int LInputQueue::getCount()
+{
+	return (Uint32)SDL_AtomicGet( &mHead ) - (Uint32)SDL_AtomicGet( &mTail );
+}
+
+int LInputQueue::getDropped()
+{
+	return SDL_AtomicGet( &mDropped );
+}
+
+int LInputQueue::filter( void* userdata, SDL_Event* event )
+{
+	//Let everything that isn't input through to SDL's queue
+	if( !isQueued( event->type ) )
+	{
+		return 1;
+	}
+
+	//Stamp the event first, as close to its arrival as we can get
+	Uint64 time = SDL_GetPerformanceCounter();
+	LInputQueue* queue = (LInputQueue*)userdata;
+	if( !queue->push( *event, time ) )
+	{
+		SDL_AtomicAdd( &queue->mDropped, 1 );
+	}
+
+	//The queue has it, SDL doesn't need to keep it
+	return 0;
+}
+
+bool LInputQueue::isQueued( Uint32 type )
+{
+	switch( type )
+	{
+		case SDL_QUIT:
+		case SDL_KEYDOWN:
+		case SDL_KEYUP:
+		case SDL_MOUSEMOTION:
+		case SDL_MOUSEBUTTONDOWN:
+		case SDL_MOUSEBUTTONUP:
+		case SDL_MOUSEWHEEL:
+			return true;
+	}
+
+	return false;
+}
+
+bool LInputQueue::push( const SDL_Event& event, Uint64 time )
+{
+	Uint32 head = SDL_AtomicGet( &mHead );
+	if( head - (Uint32)SDL_AtomicGet( &mTail ) == CAPACITY )
+	{
+		return false;
+	}
+
+	LInputEvent& slot = mEvents[ head & ( CAPACITY - 1 ) ];
+	slot.event = event;
+	slot.time = time;
+
+	//The event has to be written before the reader can see it
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet( &mHead, head + 1 );
+	return true;
+}
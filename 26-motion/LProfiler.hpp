@@ -0,0 +1,197 @@
+//Scoped zone CPU profiler
+//PROFILE_SCOPE( "name" ) times the enclosing block and PROFILE_WRITE( path )
+//saves every zone as Chrome trace event JSON, which chrome://tracing and
+//Perfetto open directly. Each thread records into its own fixed size buffer
+//so recording never locks or allocates; buffers are linked into a global
+//list with a compare and swap the first time a thread records.
+//Everything here compiles to nothing unless LPROFILER_ENABLED is defined
+#if defined(LPROFILER_ENABLED)
+
+#define LPROFILER_CONCAT_( a, b ) a##b
+#define LPROFILER_CONCAT( a, b ) LPROFILER_CONCAT_( a, b )
+
+#define PROFILE_SCOPE( name ) LProfileZone LPROFILER_CONCAT( profileZone, __LINE__ )( name )
+#define PROFILE_THREAD( name ) LProfiler::setThreadName( name )
+#define PROFILE_WRITE( path ) LProfiler::writeTrace( path )
+
+//Zone recorder and trace writer
+class LProfiler
+{
+	public:
+		//Zones each thread can hold, later zones are dropped
+		static const int EVENTS_PER_THREAD = 1 << 16;
+
+		//A finished zone, name must be a string literal
+		struct Event
+		{
+			const char* name;
+			Uint64 start;
+			Uint64 end;
+		};
+
+		//One thread's recorded zones
+		struct ThreadBuffer
+		{
+			Event events[ EVENTS_PER_THREAD ];
+			SDL_atomic_t count;
+			int dropped;
+			SDL_threadID id;
+			const char* name;
+			ThreadBuffer* next;
+		};
+
+		//Records a finished zone on the calling thread
+		static void record( const char* name, Uint64 start, Uint64 end );
+
+		//Names the calling thread in the trace
+		static void setThreadName( const char* name );
+
+		//Writes every recorded zone as Chrome trace event JSON
+		static bool writeTrace( std::string path );
+
+	private:
+		//Gets the calling thread's buffer, creating it on first use
+		static ThreadBuffer* getThreadBuffer();
+
+		//The calling thread's buffer
+		static thread_local ThreadBuffer* sThreadBuffer;
+
+		//Every thread's buffer
+		static ThreadBuffer* sThreads;
+
+		//Counter value traces are relative to
+		static Uint64 sEpoch;
+};
+
+//Times the scope it lives in
+class LProfileZone
+{
+	public:
+		//Starts timing
+		LProfileZone( const char* name );
+
+		//Records the zone
+		~LProfileZone();
+
+	private:
+		const char* mName;
+		Uint64 mStart;
+};
+
+thread_local LProfiler::ThreadBuffer* LProfiler::sThreadBuffer = NULL;
+LProfiler::ThreadBuffer* LProfiler::sThreads = NULL;
+Uint64 LProfiler::sEpoch = SDL_GetPerformanceCounter();
+
+void LProfiler::record( const char* name, Uint64 start, Uint64 end )
+{
+	ThreadBuffer* buffer = getThreadBuffer();
+
+	//Only this thread writes its buffer, publish the count after the event
+	int count = SDL_AtomicGet( &buffer->count );
+	if( count == EVENTS_PER_THREAD )
+	{
+		++buffer->dropped;
+		return;
+	}
+
+	Event& event = buffer->events[ count ];
+	event.name = name;
+	event.start = start;
+	event.end = end;
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet( &buffer->count, count + 1 );
+}
+
+void LProfiler::setThreadName( const char* name )
+{
+	getThreadBuffer()->name = name;
+}
+
+bool LProfiler::writeTrace( std::string path )
+{
+	FILE* file = fopen( path.c_str(), "w" );
+	if( file == NULL )
+	{
+		printf( "Unable to write trace %s!\n", path.c_str() );
+		return false;
+	}
+
+	//Timestamps are in microseconds
+	double toMicroseconds = 1e6 / SDL_GetPerformanceFrequency();
+
+	fprintf( file, "{\"traceEvents\":[\n" );
+	bool first = true;
+	for( ThreadBuffer* buffer = (ThreadBuffer*)SDL_AtomicGetPtr( (void**)&sThreads ); buffer != NULL; buffer = buffer->next )
+	{
+		unsigned long tid = buffer->id;
+
+		//Thread name metadata
+		if( buffer->name != NULL )
+		{
+			fprintf( file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%lu,\"args\":{\"name\":\"%s\"}}", first ? "" : ",\n", tid, buffer->name );
+			first = false;
+		}
+
+		//Complete events, read up to the published count
+		int count = SDL_AtomicGet( &buffer->count );
+		SDL_MemoryBarrierAcquire();
+		for( int i = 0; i < count; ++i )
+		{
+			Event& event = buffer->events[ i ];
+			fprintf( file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%lu,\"ts\":%.3f,\"dur\":%.3f}", first ? "" : ",\n", event.name, tid,
+				( event.start - sEpoch ) * toMicroseconds, ( event.end - event.start ) * toMicroseconds );
+			first = false;
+		}
+
+		if( buffer->dropped > 0 )
+		{
+			printf( "Profiler dropped %d zones on thread %lu\n", buffer->dropped, tid );
+		}
+	}
+	fprintf( file, "\n]}\n" );
+
+	return fclose( file ) == 0;
+}
+
+LProfiler::ThreadBuffer* LProfiler::getThreadBuffer()
+{
+	if( sThreadBuffer == NULL )
+	{
+		//Buffers live until exit so the trace can still be written after threads end
+		ThreadBuffer* buffer = new ThreadBuffer();
+		SDL_AtomicSet( &buffer->count, 0 );
+		buffer->dropped = 0;
+		buffer->id = SDL_ThreadID();
+		buffer->name = NULL;
+
+		//Push onto the thread list
+		do
+		{
+			buffer->next = (ThreadBuffer*)SDL_AtomicGetPtr( (void**)&sThreads );
+		}
+		while( !SDL_AtomicCASPtr( (void**)&sThreads, buffer->next, buffer ) );
+
+		sThreadBuffer = buffer;
+	}
+
+	return sThreadBuffer;
+}
+
+LProfileZone::LProfileZone( const char* name )
+{
+	mName = name;
+	mStart = SDL_GetPerformanceCounter();
+}
+
+LProfileZone::~LProfileZone()
+{
+	LProfiler::record( mName, mStart, SDL_GetPerformanceCounter() );
+}
+
+#else
+
+#define PROFILE_SCOPE( name )
+#define PROFILE_THREAD( name )
+#define PROFILE_WRITE( path )
+
+#endif
@@ -2,8 +2,15 @@
 #include <SDL2/SDL_image.h>
 #include <stdio.h>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include "LProfiler.hpp"
 #include "LTexture.hpp"
 #include "Dot.hpp"
+#include "LGameLoop.hpp"
+#include "LInputLog.hpp"
+#include "LInputQueue.hpp"
+#include "LBenchmark.hpp"
 
 //Screen dimension constants
 const int SCREEN_WIDTH = 640;
@@ -27,6 +34,12 @@ SDL_Renderer* gRenderer = NULL;
 //Textures
 LTexture gDotTexture;
 
+//Headless benchmark mode
+LBenchmark gBenchmark;
+
+//Input stamped with when it arrived
+LInputQueue gInputQueue;
+
 bool init()
 {
 	//Initialization flag
@@ -100,6 +113,9 @@ void close()
 	//Free loaded images
 	gDotTexture.free();
 
+	//Give events back to SDL
+	gInputQueue.stop();
+
 	//Destroy window	
 	SDL_DestroyRenderer( gRenderer );
 	SDL_DestroyWindow( gWindow );
@@ -114,6 +130,9 @@ void close()
 
 int main( int argc, char* args[] )
 {
+	/* run headless if the benchmark runner started us */
+	gBenchmark.configure("motion");
+
 	//Start up SDL and create window
 	if( !init() )
 	{
@@ -132,42 +151,98 @@ int main( int argc, char* args[] )
 			bool quit = false;
 
 			//Event handler
-			SDL_Event e;
+			LInputEvent input;
+
+			//Events other than input, which stay in SDL's queue
+			SDL_Event event;
 
 			//The dot that will be moving around on the screen
-			Dot dot = Dot(SCREEN_WIDTH, SCREEN_HEIGHT);
+			Dot dot = Dot(SCREEN_HEIGHT, SCREEN_WIDTH);
+
+			/* simulate at a fixed 120 Hz, render as fast as vsync allows */
+			LGameLoop loop(120.0);
+			loop.start();
+
+			PROFILE_THREAD("main");
+
+			gBenchmark.markLoaded();
+
+			//Take events as they arrive instead of from SDL's queue
+			gInputQueue.start();
 
 			//While application is running
 			while( !quit )
 			{
-				//Handle events on queue
-				while( SDL_PollEvent( &e ) != 0 )
+				PROFILE_SCOPE("frame");
+				gBenchmark.beginFrame();
+
+				//Fetch waiting events, they're handled by the step they arrived in
 				{
-					//User requests quit
-					if( e.type == SDL_QUIT )
-					{
-						quit = true;
-					}
+					PROFILE_SCOPE("events");
+					gInputQueue.pump();
 
-					/* handle input for the dot */
-					dot.handleEvent(e);
+					/* nothing here needs window events, SDL's renderer has already seen them, but they mustn't pile up */
+					while (SDL_PollEvent(&event) != 0)
+						;
 				}
 
-				/* move the dot */
-				dot.move();
+				/* move the dot in fixed steps */
+				{
+					PROFILE_SCOPE("update");
+					if (gBenchmark.isEnabled())
+						loop.beginFrame(gBenchmark.getFrameSeconds());
+					else
+						loop.beginFrame();
+					while (loop.step()) {
+						/*
+						 * benchmark frames have a made up length, so their
+						 * input can't be placed by arrival time, the first
+						 * step takes it all to keep replays deterministic
+						 */
+						Uint64 stepEnd = gBenchmark.isEnabled() ? ~(Uint64)0 : loop.getStepEnd();
+						while (gInputQueue.popBefore(stepEnd, input)) {
+							/* keep it for replay if recording */
+							gBenchmark.recordEvent(input.event);
+
+							//User requests quit
+							if( input.event.type == SDL_QUIT )
+							{
+								quit = true;
+							}
+
+							/* handle input for the dot */
+							dot.handleEvent(input.event);
+						}
+
+						dot.move(loop.getStep());
+					}
+				}
 
 				//Clear screen
-				SDL_SetRenderDrawColor( gRenderer, 0xFF, 0xFF, 0xFF, 0xFF );
-				SDL_RenderClear( gRenderer );
+				{
+					PROFILE_SCOPE("render");
+					SDL_SetRenderDrawColor( gRenderer, 0xFF, 0xFF, 0xFF, 0xFF );
+					SDL_RenderClear( gRenderer );
 
-				dot.render(&gDotTexture);
+					dot.render(&gDotTexture, loop.getAlpha());
+				}
 
 				//Update screen
-				SDL_RenderPresent( gRenderer );
+				{
+					PROFILE_SCOPE("present");
+					SDL_RenderPresent( gRenderer );
+				}
+
+				gBenchmark.endFrame();
 			}
+
+			gBenchmark.report();
 		}
 	}
 
+	/* save the profile, if built with one */
+	PROFILE_WRITE("motion.trace.json");
+
 	//Free resources and close SDL
 	close();
 
@@ -15,8 +15,8 @@ class Dot
 		/* takes key presses and adjusts the dot's velocity */
 		void handleEvent(SDL_Event& e);
 
-		/* moves the dot */
-		void move(SDL_Rect& wall);
+		/* moves the dot, sliding along the walls and screen edges it runs into */
+		void move(LColliderSet& walls);
 
 		/* shows the dot on the screen */
 		void render(LTexture *tex);
@@ -36,6 +36,12 @@ class Dot
 
 		/* Dot's collision box */
 		SDL_Rect mCollider;
+
+		/* walls near the dot's path, kept to avoid reallocating */
+		std::vector<Uint32> mNearby;
+
+		/* finds when box moving by moveX, moveY first touches wall, and the side it hits */
+		static bool sweep(const SDL_Rect& box, int moveX, int moveY, const SDL_Rect& wall, float& time, int& normalX, int& normalY);
 };
 
 Dot::Dot(int screen_height, int screen_width)
@@ -80,29 +86,142 @@ void Dot::handleEvent(SDL_Event& e)
 	}
 }
 
-void Dot::move(SDL_Rect& wall)
+void Dot::move(LColliderSet& walls)
 {
-	/* move the dot left or right */
-	mPosX += mVelX;
+	PROFILE_SCOPE("Dot::move");
+
+	/* the screen edges, thick enough that nothing crosses them in one move */
+	SDL_Rect edges[4] = {
+		{ -sw, -sh, sw, 3 * sh },
+		{ sw, -sh, sw, 3 * sh },
+		{ -sw, -sh, 3 * sw, sh },
+		{ -sw, sh, 3 * sw, sh },
+	};
+
+	/*
+	 * sweep the box along the move instead of jumping to the end, so fast
+	 * dots can't pass through thin walls. at the first thing hit the dot
+	 * stops in contact and the rest of the move continues along the
+	 * surface, each hit removes one axis so two passes always finish
+	 */
 	mCollider.x = mPosX;
+	mCollider.y = mPosY;
+	int moveX = mVelX, moveY = mVelY;
+	for (int pass = 0; pass < 2 && (moveX != 0 || moveY != 0); ++pass) {
+		/* the area the whole move covers finds the nearby walls */
+		SDL_Rect path;
+		path.x = mCollider.x + SDL_min(moveX, 0);
+		path.y = mCollider.y + SDL_min(moveY, 0);
+		path.w = mCollider.w + SDL_abs(moveX);
+		path.h = mCollider.h + SDL_abs(moveY);
+		walls.overlapMasks(path, mNearby);
+
+		/* the earliest hit wins */
+		float hitTime = 1;
+		int normalX = 0, normalY = 0;
+		SDL_Rect hitWall;
+		for (int i = 0; i < walls.getCount() + 4; ++i) {
+			SDL_Rect wall;
+			if (i < walls.getCount()) {
+				if (!(mNearby[i / 32] >> (i % 32) & 1))
+					continue;
+				wall = walls.getBox(i);
+			} else {
+				wall = edges[i - walls.getCount()];
+			}
 
-	/* if the dot collided or went too far to the left or right */
-	if ((mPosX < 0) || (mPosX + DOT_WIDTH > sw) || checkCollision(mCollider, wall)) {
-		/* move back */
-		mPosX -= mVelX;
+			float time;
+			int nx, ny;
+			if (sweep(mCollider, moveX, moveY, wall, time, nx, ny) && time < hitTime) {
+				hitTime = time;
+				normalX = nx;
+				normalY = ny;
+				hitWall = wall;
+			}
+		}
+
+		/* nothing in the way */
+		if (normalX == 0 && normalY == 0) {
+			mPosX += moveX;
+			mPosY += moveY;
+			mCollider.x = mPosX;
+			mCollider.y = mPosY;
+			break;
+		}
+
+		/*
+		 * stop flush against the wall on the hit axis, the other axis goes
+		 * as far as it got by then, rounded back towards the start so the
+		 * box never ends up inside anything
+		 */
+		if (normalX != 0) {
+			mPosX = normalX < 0 ? hitWall.x - mCollider.w : hitWall.x + hitWall.w;
+			int moved = (int)(moveY * hitTime);
+			mPosY += moved;
+			moveX = 0;
+			moveY -= moved;
+		} else {
+			mPosY = normalY < 0 ? hitWall.y - mCollider.h : hitWall.y + hitWall.h;
+			int moved = (int)(moveX * hitTime);
+			mPosX += moved;
+			moveX -= moved;
+			moveY = 0;
+		}
 		mCollider.x = mPosX;
+		mCollider.y = mPosY;
 	}
+}
 
-	/* move the dot up or down */
-	mPosY += mVelY;
-	mCollider.y = mPosY;
+bool Dot::sweep(const SDL_Rect& box, int moveX, int moveY, const SDL_Rect& wall, float& time, int& normalX, int& normalY)
+{
+	/* the times the box starts and stops overlapping the wall on each axis */
+	float entryX, exitX, entryY, exitY;
 
-	/* if the dot went too far up or down */
-	if ((mPosY < 0) || (mPosY + DOT_HEIGHT > sh) || checkCollision(mCollider, wall)) {
-		/* move back */
-		mPosY -= mVelY;
-		mCollider.y = mPosY;
+	if (moveX > 0) {
+		entryX = (float)(wall.x - (box.x + box.w)) / moveX;
+		exitX = (float)(wall.x + wall.w - box.x) / moveX;
+	} else if (moveX < 0) {
+		entryX = (float)(box.x - (wall.x + wall.w)) / -moveX;
+		exitX = (float)(box.x + box.w - wall.x) / -moveX;
+	} else if (box.x < wall.x + wall.w && wall.x < box.x + box.w) {
+		/* not moving but already in line, overlapping the whole time */
+		entryX = -SDL_MAX_SINT32;
+		exitX = SDL_MAX_SINT32;
+	} else {
+		return false;
 	}
+
+	if (moveY > 0) {
+		entryY = (float)(wall.y - (box.y + box.h)) / moveY;
+		exitY = (float)(wall.y + wall.h - box.y) / moveY;
+	} else if (moveY < 0) {
+		entryY = (float)(box.y - (wall.y + wall.h)) / -moveY;
+		exitY = (float)(box.y + box.h - wall.y) / -moveY;
+	} else if (box.y < wall.y + wall.h && wall.y < box.y + box.h) {
+		entryY = -SDL_MAX_SINT32;
+		exitY = SDL_MAX_SINT32;
+	} else {
+		return false;
+	}
+
+	/*
+	 * the box overlaps the wall once it overlaps on both axes. boxes already
+	 * inside a wall are let out, and only touching a corner doesn't count
+	 */
+	float entry = SDL_max(entryX, entryY);
+	float exit = SDL_min(exitX, exitY);
+	if (entry < 0 || entry >= 1 || entry >= exit)
+		return false;
+
+	/* the axis that started overlapping last is the side that was hit */
+	time = entry;
+	normalX = normalY = 0;
+	if (entryX > entryY)
+		normalX = moveX > 0 ? -1 : 1;
+	else
+		normalY = moveY > 0 ? -1 : 1;
+
+	return true;
 }
 
 void Dot::render(LTexture *tex)
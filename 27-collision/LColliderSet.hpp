@@ -0,0 +1,273 @@
+//Collider set tested several boxes at a time
+//Boxes are stored as separate left, top, right and bottom arrays so one box
+//can be compared against 4 (SSE2) or 8 (AVX2) stored boxes per instruction.
+//Results come back as hit masks, one bit per box. The arrays are padded to a
+//whole number of AVX2 blocks with boxes that never overlap anything, so the
+//kernels need no tail handling. Other CPUs use the scalar kernel
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LCOLLIDERSET_X86
+#endif
+
+class LColliderSet
+{
+	public:
+		//Boxes tested per block, the AVX2 width
+		static const int BLOCK = 8;
+
+		//Initializes variables
+		LColliderSet();
+
+		//Adds a box and returns its index
+		int add( const SDL_Rect& box );
+
+		//Moves a box
+		void set( int index, const SDL_Rect& box );
+
+		//Removes every box
+		void clear();
+
+		//Gets a box
+		SDL_Rect getBox( int index );
+
+		//Gets the number of boxes
+		int getCount();
+
+		//Sets bit i % 32 of masks[ i / 32 ] for every box i overlapping box, with the fastest kernel available
+		void overlapMasks( const SDL_Rect& box, std::vector<Uint32>& masks );
+
+		//Checks whether any box overlaps box, stopping at the first block with a hit
+		bool overlapsAny( const SDL_Rect& box );
+
+		//The individual kernels, test boxes first to last and OR box first + n into bit n % 32 of masks[ n / 32 ]
+		//first and last must be multiples of BLOCK no larger than getPaddedCount()
+		void overlapScalar( const SDL_Rect& box, int first, int last, Uint32* masks );
+#if defined(LCOLLIDERSET_X86)
+		void overlapSSE2( const SDL_Rect& box, int first, int last, Uint32* masks );
+		void overlapAVX2( const SDL_Rect& box, int first, int last, Uint32* masks );
+#endif
+
+		//Gets the number of boxes including padding
+		int getPaddedCount();
+
+	private:
+		//Runs the fastest kernel available
+		void overlap( const SDL_Rect& box, int first, int last, Uint32* masks );
+
+		//Writes a box's edges, empty boxes get edges nothing can overlap
+		void store( int index, const SDL_Rect& box );
+
+		//Checks the CPU once, 2 for AVX2, 1 for SSE2, 0 for neither
+		static int getSimdLevel();
+
+		//Box edges, right and bottom are exclusive
+		std::vector<int> mLeft;
+		std::vector<int> mTop;
+		std::vector<int> mRight;
+		std::vector<int> mBottom;
+
+		//Number of boxes, the arrays are padded past it
+		int mCount;
+};
+
+LColliderSet::LColliderSet()
+{
+	//Initialize
+	mCount = 0;
+}
+
+int LColliderSet::add( const SDL_Rect& box )
+{
+	//Grow by a whole block of never overlapping boxes
+	if( mCount == mLeft.size() )
+	{
+		mLeft.resize( mCount + BLOCK, SDL_MAX_SINT32 );
+		mTop.resize( mCount + BLOCK, SDL_MAX_SINT32 );
+		mRight.resize( mCount + BLOCK, SDL_MIN_SINT32 );
+		mBottom.resize( mCount + BLOCK, SDL_MIN_SINT32 );
+	}
+
+	store( mCount, box );
+	return mCount++;
+}
+
+void LColliderSet::set( int index, const SDL_Rect& box )
+{
+	store( index, box );
+}
+
+void LColliderSet::clear()
+{
+	mLeft.clear();
+	mTop.clear();
+	mRight.clear();
+	mBottom.clear();
+	mCount = 0;
+}
+
+SDL_Rect LColliderSet::getBox( int index )
+{
+	SDL_Rect box = { 0, 0, 0, 0 };
+	if( mRight[ index ] > mLeft[ index ] )
+	{
+		box.x = mLeft[ index ];
+		box.y = mTop[ index ];
+		box.w = mRight[ index ] - mLeft[ index ];
+		box.h = mBottom[ index ] - mTop[ index ];
+	}
+	return box;
+}
+
+int LColliderSet::getCount()
+{
+	return mCount;
+}
+
+int LColliderSet::getPaddedCount()
+{
+	return mLeft.size();
+}
+
+void LColliderSet::overlapMasks( const SDL_Rect& box, std::vector<Uint32>& masks )
+{
+	masks.assign( ( mLeft.size() + 31 ) / 32, 0 );
+	if( !masks.empty() )
+	{
+		overlap( box, 0, mLeft.size(), &masks[ 0 ] );
+	}
+}
+
+bool LColliderSet::overlapsAny( const SDL_Rect& box )
+{
+	//A word's worth of boxes at a time so a hit ends the search early
+	for( int first = 0; first < mLeft.size(); first += 32 )
+	{
+		Uint32 mask = 0;
+		overlap( box, first, SDL_min( first + 32, (int)mLeft.size() ), &mask );
+		if( mask != 0 )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void LColliderSet::overlap( const SDL_Rect& box, int first, int last, Uint32* masks )
+{
+#if defined(LCOLLIDERSET_X86)
+	int simd = getSimdLevel();
+	if( simd == 2 )
+	{
+		overlapAVX2( box, first, last, masks );
+		return;
+	}
+	if( simd == 1 )
+	{
+		overlapSSE2( box, first, last, masks );
+		return;
+	}
+#endif
+	overlapScalar( box, first, last, masks );
+}
+
+void LColliderSet::overlapScalar( const SDL_Rect& box, int first, int last, Uint32* masks )
+{
+	//Empty boxes overlap nothing, like SDL_HasIntersection
+	if( box.w <= 0 || box.h <= 0 )
+	{
+		return;
+	}
+
+	int left = box.x;
+	int top = box.y;
+	int right = box.x + box.w;
+	int bottom = box.y + box.h;
+	for( int i = first; i < last; ++i )
+	{
+		if( left < mRight[ i ] && mLeft[ i ] < right && top < mBottom[ i ] && mTop[ i ] < bottom )
+		{
+			masks[ ( i - first ) / 32 ] |= (Uint32)1 << ( ( i - first ) % 32 );
+		}
+	}
+}
+
+#if defined(LCOLLIDERSET_X86)
+__attribute__(( target( "sse2" ) ))
+void LColliderSet::overlapSSE2( const SDL_Rect& box, int first, int last, Uint32* masks )
+{
+	if( box.w <= 0 || box.h <= 0 )
+	{
+		return;
+	}
+
+	__m128i left = _mm_set1_epi32( box.x );
+	__m128i top = _mm_set1_epi32( box.y );
+	__m128i right = _mm_set1_epi32( box.x + box.w );
+	__m128i bottom = _mm_set1_epi32( box.y + box.h );
+
+	//Four boxes per step, the edge tests are signed compares ANDed together
+	for( int i = first; i < last; i += 4 )
+	{
+		__m128i hit = _mm_cmpgt_epi32( _mm_loadu_si128( (const __m128i*)&mRight[ i ] ), left );
+		hit = _mm_and_si128( hit, _mm_cmpgt_epi32( right, _mm_loadu_si128( (const __m128i*)&mLeft[ i ] ) ) );
+		hit = _mm_and_si128( hit, _mm_cmpgt_epi32( _mm_loadu_si128( (const __m128i*)&mBottom[ i ] ), top ) );
+		hit = _mm_and_si128( hit, _mm_cmpgt_epi32( bottom, _mm_loadu_si128( (const __m128i*)&mTop[ i ] ) ) );
+
+		//One bit per lane
+		masks[ ( i - first ) / 32 ] |= (Uint32)_mm_movemask_ps( _mm_castsi128_ps( hit ) ) << ( ( i - first ) % 32 );
+	}
+}
+
+__attribute__(( target( "avx2" ) ))
+void LColliderSet::overlapAVX2( const SDL_Rect& box, int first, int last, Uint32* masks )
+{
+	if( box.w <= 0 || box.h <= 0 )
+	{
+		return;
+	}
+
+	__m256i left = _mm256_set1_epi32( box.x );
+	__m256i top = _mm256_set1_epi32( box.y );
+	__m256i right = _mm256_set1_epi32( box.x + box.w );
+	__m256i bottom = _mm256_set1_epi32( box.y + box.h );
+
+	//Eight boxes per step
+	for( int i = first; i < last; i += BLOCK )
+	{
+		__m256i hit = _mm256_cmpgt_epi32( _mm256_loadu_si256( (const __m256i*)&mRight[ i ] ), left );
+		hit = _mm256_and_si256( hit, _mm256_cmpgt_epi32( right, _mm256_loadu_si256( (const __m256i*)&mLeft[ i ] ) ) );
+		hit = _mm256_and_si256( hit, _mm256_cmpgt_epi32( _mm256_loadu_si256( (const __m256i*)&mBottom[ i ] ), top ) );
+		hit = _mm256_and_si256( hit, _mm256_cmpgt_epi32( bottom, _mm256_loadu_si256( (const __m256i*)&mTop[ i ] ) ) );
+
+		masks[ ( i - first ) / 32 ] |= (Uint32)_mm256_movemask_ps( _mm256_castsi256_ps( hit ) ) << ( ( i - first ) % 32 );
+	}
+}
+#endif
+
+void LColliderSet::store( int index, const SDL_Rect& box )
+{
+	if( box.w <= 0 || box.h <= 0 )
+	{
+		mLeft[ index ] = SDL_MAX_SINT32;
+		mTop[ index ] = SDL_MAX_SINT32;
+		mRight[ index ] = SDL_MIN_SINT32;
+		mBottom[ index ] = SDL_MIN_SINT32;
+		return;
+	}
+
+	mLeft[ index ] = box.x;
+	mTop[ index ] = box.y;
+	mRight[ index ] = box.x + box.w;
+	mBottom[ index ] = box.y + box.h;
+}
+
+int LColliderSet::getSimdLevel()
+{
+#if defined(LCOLLIDERSET_X86)
+	static int simd = SDL_HasAVX2() ? 2 : SDL_HasSSE2() ? 1 : 0;
+	return simd;
+#else
+	return 0;
+#endif
+}
@@ -132,6 +132,8 @@ void LTexture::setAlpha( Uint8 alpha )
 
 void LTexture::render( int x, int y, SDL_Rect* clip, double angle, SDL_Point* center, SDL_RendererFlip flip )
 {
+	PROFILE_SCOPE( "LTexture::render" );
+
 	//Set renering space 
 	SDL_Rect renderQuad = { x, y, mWidth, mHeight };
 
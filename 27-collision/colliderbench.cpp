@@ -0,0 +1,178 @@
+//Benchmarks the collider set kernels against an SDL_HasIntersection loop
+//usage: colliderbench [boxes] [queries] [runs]
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "LColliderSet.hpp"
+
+//A kernel under test
+typedef void (LColliderSet::*OverlapKernel)( const SDL_Rect& box, int first, int last, Uint32* masks );
+
+//Size of the area the boxes are scattered over
+const int WORLD_SIZE = 4096;
+
+//Gets elapsed milliseconds between two performance counter readings
+double elapsedMs( Uint64 start, Uint64 end )
+{
+	return (double)( end - start ) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+//Prints a result line
+void report( const char* name, double ms, size_t pairs )
+{
+	printf( "%-24s %9.3f ms %9.3f ns/pair %9.1f Mpairs/s\n", name, ms, ms * 1000000.0 / pairs, pairs / ( ms * 1000.0 ) );
+}
+
+//Makes a box somewhere in the world
+SDL_Rect randomBox( int minSize, int maxSize )
+{
+	SDL_Rect box;
+	box.w = minSize + rand() % ( maxSize - minSize + 1 );
+	box.h = minSize + rand() % ( maxSize - minSize + 1 );
+	box.x = rand() % WORLD_SIZE - box.w / 2;
+	box.y = rand() % WORLD_SIZE - box.h / 2;
+	return box;
+}
+
+//Times a kernel over every query, returning the best run and the masks of the last
+double timeKernel( LColliderSet& set, OverlapKernel kernel, const std::vector<SDL_Rect>& queries, std::vector<Uint32>& masks, int runs )
+{
+	int words = ( set.getPaddedCount() + 31 ) / 32;
+	masks.assign( (size_t)words * queries.size(), 0 );
+
+	double best = 0;
+	for( int i = 0; i < runs; ++i )
+	{
+		memset( &masks[ 0 ], 0, masks.size() * sizeof( Uint32 ) );
+		Uint64 start = SDL_GetPerformanceCounter();
+		for( int q = 0; q < queries.size(); ++q )
+		{
+			( set.*kernel )( queries[ q ], 0, set.getPaddedCount(), &masks[ (size_t)q * words ] );
+		}
+		double ms = elapsedMs( start, SDL_GetPerformanceCounter() );
+		if( i == 0 || ms < best )
+		{
+			best = ms;
+		}
+	}
+	return best;
+}
+
+int main( int argc, char* args[] )
+{
+	int boxCount = argc > 1 ? atoi( args[ 1 ] ) : 4096;
+	int queryCount = argc > 2 ? atoi( args[ 2 ] ) : 1024;
+	int runs = argc > 3 ? atoi( args[ 3 ] ) : 10;
+	if( boxCount <= 0 || queryCount <= 0 || runs <= 0 )
+	{
+		printf( "usage: %s [boxes] [queries] [runs]\n", args[ 0 ] );
+		return 1;
+	}
+
+	if( SDL_Init( 0 ) < 0 )
+	{
+		printf( "Unable to initialize SDL! SDL Error: %s\n", SDL_GetError() );
+		return 1;
+	}
+
+	//Walls of assorted sizes and dot sized queries, a few of them empty
+	srand( 1 );
+	std::vector<SDL_Rect> boxes;
+	LColliderSet set;
+	for( int i = 0; i < boxCount; ++i )
+	{
+		SDL_Rect box = randomBox( 4, 128 );
+		if( rand() % 64 == 0 )
+		{
+			box.w = 0;
+		}
+		boxes.push_back( box );
+		set.add( box );
+	}
+
+	std::vector<SDL_Rect> queries;
+	for( int i = 0; i < queryCount; ++i )
+	{
+		queries.push_back( randomBox( 20, 20 ) );
+	}
+
+	size_t pairs = (size_t)boxCount * queryCount;
+	printf( "%d boxes, %d queries, best of %d runs\n", boxCount, queryCount, runs );
+
+	//The pair at a time loop over SDL_Rects, building the same masks
+	int words = ( set.getPaddedCount() + 31 ) / 32;
+	std::vector<Uint32> expected( (size_t)words * queryCount );
+	double sdlMs = 0;
+	for( int i = 0; i < runs; ++i )
+	{
+		memset( &expected[ 0 ], 0, expected.size() * sizeof( Uint32 ) );
+		Uint64 start = SDL_GetPerformanceCounter();
+		for( int q = 0; q < queryCount; ++q )
+		{
+			Uint32* masks = &expected[ (size_t)q * words ];
+			for( int b = 0; b < boxCount; ++b )
+			{
+				if( SDL_HasIntersection( &queries[ q ], &boxes[ b ] ) )
+				{
+					masks[ b / 32 ] |= (Uint32)1 << ( b % 32 );
+				}
+			}
+		}
+		double ms = elapsedMs( start, SDL_GetPerformanceCounter() );
+		if( i == 0 || ms < sdlMs )
+		{
+			sdlMs = ms;
+		}
+	}
+	report( "SDL_HasIntersection", sdlMs, pairs );
+
+	//Time each kernel and check it against SDL
+	bool success = true;
+	std::vector<Uint32> output;
+	double ms = timeKernel( set, &LColliderSet::overlapScalar, queries, output, runs );
+	report( "scalar", ms, pairs );
+	if( output != expected )
+	{
+		printf( "Scalar masks differ from SDL!\n" );
+		success = false;
+	}
+
+#if defined(LCOLLIDERSET_X86)
+	if( SDL_HasSSE2() )
+	{
+		ms = timeKernel( set, &LColliderSet::overlapSSE2, queries, output, runs );
+		report( "sse2", ms, pairs );
+		if( output != expected )
+		{
+			printf( "SSE2 masks differ from SDL!\n" );
+			success = false;
+		}
+	}
+
+	if( SDL_HasAVX2() )
+	{
+		ms = timeKernel( set, &LColliderSet::overlapAVX2, queries, output, runs );
+		report( "avx2", ms, pairs );
+		if( output != expected )
+		{
+			printf( "AVX2 masks differ from SDL!\n" );
+			success = false;
+		}
+	}
+#endif
+
+	//The early out query the dot uses
+	int hits = 0;
+	Uint64 start = SDL_GetPerformanceCounter();
+	for( int q = 0; q < queryCount; ++q )
+	{
+		hits += set.overlapsAny( queries[ q ] );
+	}
+	printf( "overlapsAny %d of %d queries hit in %.3f ms\n", hits, queryCount, elapsedMs( start, SDL_GetPerformanceCounter() ) );
+
+	SDL_Quit();
+
+	return success ? 0 : 1;
+}
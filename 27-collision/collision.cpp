@@ -2,8 +2,14 @@
 #include <SDL2/SDL_image.h>
 #include <stdio.h>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include "LProfiler.hpp"
 #include "LTexture.hpp"
+#include "LColliderSet.hpp"
 #include "Dot.hpp"
+#include "LInputLog.hpp"
+#include "LBenchmark.hpp"
 
 //Screen dimension constants
 const int SCREEN_WIDTH = 640;
@@ -27,6 +33,9 @@ SDL_Renderer* gRenderer = NULL;
 //Textures
 LTexture gDotTexture;
 
+//Headless benchmark mode
+LBenchmark gBenchmark;
+
 bool init()
 {
 	//Initialization flag
@@ -114,6 +123,9 @@ void close()
 
 int main( int argc, char* args[] )
 {
+	/* run headless if the benchmark runner started us */
+	gBenchmark.configure("collision");
+
 	//Start up SDL and create window
 	if( !init() )
 	{
@@ -135,7 +147,7 @@ int main( int argc, char* args[] )
 			SDL_Event e;
 
 			//The dot that will be moving around on the screen
-			Dot dot = Dot(SCREEN_WIDTH, SCREEN_HEIGHT);
+			Dot dot = Dot(SCREEN_HEIGHT, SCREEN_WIDTH);
 
 			/* set the wall */
 			SDL_Rect wall;
@@ -144,42 +156,75 @@ int main( int argc, char* args[] )
 			wall.w = 40;
 			wall.h = 400;
 
+			/* the walls the dot is tested against */
+			LColliderSet walls;
+			walls.add(wall);
+
+			PROFILE_THREAD("main");
+
+			gBenchmark.markLoaded();
+
 			//While application is running
 			while( !quit )
 			{
+				PROFILE_SCOPE("frame");
+				gBenchmark.beginFrame();
+
 				//Handle events on queue
-				while( SDL_PollEvent( &e ) != 0 )
 				{
-					//User requests quit
-					if( e.type == SDL_QUIT )
+					PROFILE_SCOPE("events");
+					while( SDL_PollEvent( &e ) != 0 )
 					{
-						quit = true;
-					}
+						/* keep it for replay if recording */
+						gBenchmark.recordEvent(e);
+
+						//User requests quit
+						if( e.type == SDL_QUIT )
+						{
+							quit = true;
+						}
 
-					/* handle input for the dot */
-					dot.handleEvent(e);
+						/* handle input for the dot */
+						dot.handleEvent(e);
+					}
 				}
 
 				/* move the dot */
-				dot.move(wall);
+				{
+					PROFILE_SCOPE("update");
+					dot.move(walls);
+				}
 
 				//Clear screen
-				SDL_SetRenderDrawColor( gRenderer, 0xFF, 0xFF, 0xFF, 0xFF );
-				SDL_RenderClear( gRenderer );
+				{
+					PROFILE_SCOPE("render");
+					SDL_SetRenderDrawColor( gRenderer, 0xFF, 0xFF, 0xFF, 0xFF );
+					SDL_RenderClear( gRenderer );
 
-				/* render wall */
-				SDL_SetRenderDrawColor( gRenderer, 0x00, 0x00, 0x00, 0xFF );
-				SDL_RenderDrawRect(gRenderer, &wall);
+					/* render wall */
+					SDL_SetRenderDrawColor( gRenderer, 0x00, 0x00, 0x00, 0xFF );
+					SDL_RenderDrawRect(gRenderer, &wall);
 
-				/* render dot */
-				dot.render(&gDotTexture);
+					/* render dot */
+					dot.render(&gDotTexture);
+				}
 
 				//Update screen
-				SDL_RenderPresent( gRenderer );
+				{
+					PROFILE_SCOPE("present");
+					SDL_RenderPresent( gRenderer );
+				}
+
+				gBenchmark.endFrame();
 			}
+
+			gBenchmark.report();
 		}
 	}
 
+	/* save the profile, if built with one */
+	PROFILE_WRITE("collision.trace.json");
+
 	//Free resources and close SDL
 	close();
 
@@ -15,17 +15,35 @@ class Dot
 		/* takes key presses and adjusts the dot's velocity */
 		void handleEvent(SDL_Event& e);
 
-		/* moves the dot */
-		void move(std::vector<SDL_Rect>& otherColliders);
+		/* moves the dot, stopping at other boxes in the world */
+		void move(LSpatialHash& world);
 
 		/* shows the dot on the screen */
 		void render(LTexture *tex);
 
-		/* gets the collision boxes */
-		std::vector<SDL_Rect>& getColliders();
+		/* adds the dot to a frame snapshot drawn later on the render thread */
+		void render(LFrameSnapshot& frame, LTexture *tex);
 
-		/* box set collision detector */
-		bool checkCollision(std::vector<SDL_Rect>& a, std::vector<SDL_Rect>& b);
+		/* sets the pixels the dot collides with, without one the whole box is solid */
+		void setMask(LCollisionMask *mask);
+
+		/* gets the collision box */
+		SDL_Rect& getCollider();
+
+		/* adds the collision box to the world, where it follows the dot */
+		void attach(LSpatialHash& world);
+
+		/* takes the collision box out of the world */
+		void detach();
+
+		/* checks the dot's pixels against another dot's */
+		bool checkCollision(Dot& other);
+
+		/* checks the dot's pixels against a solid box */
+		bool checkCollision(const SDL_Rect& box);
+
+		/* checks the dot against everything in the world that isn't the dot */
+		bool checkCollision(LSpatialHash& world);
 
 	private:
 		/* the screen height and width */
@@ -37,10 +55,18 @@ class Dot
 		/* the velocity of the dot */
 		int mVelX, mVelY;
 
-		/* dot's collision boxes */
-		std::vector<SDL_Rect> mColliders;
+		/* dot's collision box and the solid pixels inside it */
+		SDL_Rect mCollider;
+		LCollisionMask *mMask;
 
-		/* moves the collision boxes relative to the dot's offset */
+		/* the world the box is in and its id there */
+		LSpatialHash *mWorld;
+		int mColliderId;
+
+		/* world boxes near the dot, kept to avoid reallocating */
+		std::vector<int> mNearby;
+
+		/* moves the collision box to the dot's offset */
 		void shiftColliders();
 };
 
@@ -54,48 +80,18 @@ Dot::Dot(int screen_width, int screen_height, int xpos, int ypos)
 	mPosX = xpos;
 	mPosY = ypos;
 
-	/* create the necessary SDL_Rects */
-	mColliders.resize(11);
-
 	/* initialize the velocity */
 	mVelX = 0;
 	mVelY = 0;
 
-	/* initialize the collision boxes' width and height */
-	mColliders[0].w = 6;
-	mColliders[0].h = 1;
-
-	mColliders[1].w = 10;
-	mColliders[1].h = 1;
-
-	mColliders[2].w = 14;
-	mColliders[2].h = 1;
-
-	mColliders[3].w = 16;
-	mColliders[3].h = 2;
+	/* no pixels yet and not in a world */
+	mMask = NULL;
+	mWorld = NULL;
+	mColliderId = -1;
 
-	mColliders[4].w = 18;
-	mColliders[4].h = 2;
-
-	mColliders[5].w = 20;
-	mColliders[5].h = 6;
-
-	mColliders[6].w = 18;
-	mColliders[6].h = 2;
-
-	mColliders[7].w = 16;
-	mColliders[7].h = 2;
-
-	mColliders[8].w = 14;
-	mColliders[8].h = 1;
-
-	mColliders[9].w = 10;
-	mColliders[9].h = 1;
-
-	mColliders[10].w = 6;
-	mColliders[10].h = 1;
-
-	/* initialize colliders relative to position */
+	/* initialize the collision box */
+	mCollider.w = DOT_WIDTH;
+	mCollider.h = DOT_HEIGHT;
 	shiftColliders();
 }
 
@@ -122,14 +118,14 @@ void Dot::handleEvent(SDL_Event& e)
 	}
 }
 
-void Dot::move(std::vector<SDL_Rect>& otherColliders)
+void Dot::move(LSpatialHash& world)
 {
 	/* move the dot left or right */
 	mPosX += mVelX;
 	shiftColliders();
 
 	/* if the dot collided or went too far to the left or right */
-	if ((mPosX < 0) || (mPosX + DOT_WIDTH > sw) || checkCollision(mColliders, otherColliders)) {
+	if ((mPosX < 0) || (mPosX + DOT_WIDTH > sw) || checkCollision(world)) {
 		/* move back */
 		mPosX -= mVelX;
 		shiftColliders();
@@ -140,7 +136,7 @@ void Dot::move(std::vector<SDL_Rect>& otherColliders)
 	shiftColliders();
 
 	/* if the dot went too far up or down */
-	if ((mPosY < 0) || (mPosY + DOT_HEIGHT > sh) || checkCollision(mColliders, otherColliders)) {
+	if ((mPosY < 0) || (mPosY + DOT_HEIGHT > sh) || checkCollision(world)) {
 		/* move back */
 		mPosY -= mVelY;
 		shiftColliders();
@@ -153,56 +149,97 @@ void Dot::render(LTexture *tex)
 	tex->render(mPosX, mPosY);
 }
 
-bool Dot::checkCollision(SDL_Rect a, SDL_Rect b)
+void Dot::render(LFrameSnapshot& frame, LTexture *tex)
 {
-//	
-//	/* the sides of the rectangles */
-//	int leftA, leftB;
-//	int rightA, rightB;
-//	int topA, topB;
-//	int bottomA, bottomB;
-//
-//	/* calculate the sides of rect A */
-//	leftA = a.x;
-//	rightA = a.x + a.w;
-//	topA = a.y;
-//	bottomA = a.y + a.h;
-//
-//	/* calculate the sides of rect B */
-//	leftB = b.x;
-//	rightB = b.x + b.w;
-//	topB = b.y;
-//	bottomB = b.y + b.h;
-//
-//	/* if any of the sides from A are outside of B */
-//	if (bottomA <= topB) return false;
-//	if (topA >= bottomB) return false;
-//	if (rightA <= leftB) return false;
-//	if (leftA >= rightB) return false;
-	if (SDL_HasIntersection(&a, &b)) return true;
-
-	/* if none of the sides from A are outside B */
-	return false;
+	/* only the position is copied, the texture is drawn later */
+	frame.addSprite(tex, mPosX, mPosY);
 }
 
-std::vector<SDL_Rect& Dot::getColliders()
+void Dot::setMask(LCollisionMask *mask)
 {
-	/* the row offset */
+	mMask = mask;
+
+	/* the box covers the mask */
+	if (mMask != NULL) {
+		mCollider.w = mMask->getWidth();
+		mCollider.h = mMask->getHeight();
+	} else {
+		mCollider.w = DOT_WIDTH;
+		mCollider.h = DOT_HEIGHT;
+	}
+	shiftColliders();
+}
 
-void Dot::shiftColliders()
+SDL_Rect& Dot::getCollider()
 {
-	/* the row offset */
-	int r = 0;
+	return mCollider;
+}
+
+void Dot::attach(LSpatialHash& world)
+{
+	detach();
+
+	mWorld = &world;
+	mColliderId = world.insert(mCollider, this);
+}
+
+void Dot::detach()
+{
+	if (mWorld == NULL)
+		return;
+
+	mWorld->remove(mColliderId);
+	mColliderId = -1;
+	mWorld = NULL;
+}
 
-	/* go through the dot's collsion boxes */
-	for (int set = 0; set < mColliders.size(); ++set) {
-		/* center the collision box */
-		mColliders[set].x = mPosX + (DOT_WIDTH - mColliders[set].w) / 2;
+bool Dot::checkCollision(Dot& other)
+{
+	/* without masks the boxes decide */
+	if (mMask == NULL && other.mMask == NULL)
+		return SDL_HasIntersection(&mCollider, &other.mCollider);
+	if (mMask == NULL)
+		return other.checkCollision(mCollider);
+	if (other.mMask == NULL)
+		return checkCollision(other.mCollider);
+
+	return mMask->collides(mPosX, mPosY, *other.mMask, other.mPosX, other.mPosY);
+}
 
-		/* set the collision box at its row offset */
-		mColliders[set].y = mPosY + r;
+bool Dot::checkCollision(const SDL_Rect& box)
+{
+	if (mMask == NULL)
+		return SDL_HasIntersection(&mCollider, &box);
 
-		/* move the row offset down the height of the collision box */
-		r += mColliders[set].h;
+	return mMask->collides(mPosX, mPosY, box);
+}
+
+bool Dot::checkCollision(LSpatialHash& world)
+{
+	/* one broadphase query for the whole dot */
+	world.query(mCollider, mNearby, this);
+
+	/* then exact pixels against what's nearby, boxes owned by a dot are that dot */
+	for (int n = 0; n < mNearby.size(); ++n) {
+		Dot *owner = (Dot *)world.getOwner(mNearby[n]);
+		if (owner != NULL) {
+			if (checkCollision(*owner))
+				return true;
+		} else if (checkCollision(world.getBox(mNearby[n]))) {
+			return true;
+		}
 	}
+
+	return false;
+}
+
+void Dot::shiftColliders()
+{
+	/* the box sits at the dot's offset */
+	mCollider.x = mPosX;
+	mCollider.y = mPosY;
+
+	/* keep the world's copy in step */
+	if (mWorld != NULL)
+		mWorld->update(mColliderId, mCollider);
 }
@@ -0,0 +1,248 @@
+//Per-pixel collision mask
+//One bit per pixel, set where the image is solid, packed into 64-bit words
+//per row with the leftmost pixel in the lowest bit. Two masks are compared a
+//row at a time by shifting one row's bits into line with the other's and
+//ANDing 64 pixels at once, after their bounding boxes are checked
+class LCollisionMask
+{
+	public:
+		//Pixels with at least this much alpha are solid
+		static const Uint8 ALPHA_THRESHOLD = 128;
+
+		//Initializes variables
+		LCollisionMask();
+
+		//Builds the mask from the image at specified path, color keyed like LTexture
+		bool loadFromFile( std::string path );
+
+		//Builds the mask from a surface's alpha and color key
+		bool loadFromSurface( SDL_Surface* surface );
+
+		//Deallocates the mask
+		void free();
+
+		//Checks whether a pixel is solid
+		bool isSolid( int x, int y );
+
+		//Checks this mask at x, y against another mask at otherX, otherY
+		bool collides( int x, int y, LCollisionMask& other, int otherX, int otherY );
+
+		//Checks this mask at x, y against a solid box
+		bool collides( int x, int y, const SDL_Rect& box );
+
+		//Gets mask dimensions
+		int getWidth();
+		int getHeight();
+
+	private:
+		//Gets 64 bits of a row starting at pixel x, zero past the row's end
+		Uint64 getBits( int row, int x );
+
+		//Mask dimensions and words per row
+		int mWidth;
+		int mHeight;
+		int mRowWords;
+
+		//The packed rows
+		std::vector<Uint64> mBits;
+};
+
+LCollisionMask::LCollisionMask()
+{
+	//Initialize
+	mWidth = 0;
+	mHeight = 0;
+	mRowWords = 0;
+}
+
+bool LCollisionMask::loadFromFile( std::string path )
+{
+	//Load image at specified path
+	SDL_Surface* loadedSurface = IMG_Load( path.c_str() );
+	if( loadedSurface == NULL )
+	{
+		printf( "Unable to load image %s! SDL_image Error: %s\n", path.c_str(), IMG_GetError() );
+		return false;
+	}
+
+	//Color key image
+	SDL_SetColorKey( loadedSurface, SDL_TRUE, SDL_MapRGB( loadedSurface->format, 0, 0xFF, 0xFF ) );
+
+	bool success = loadFromSurface( loadedSurface );
+
+	//Get rid of old loaded surface
+	SDL_FreeSurface( loadedSurface );
+
+	return success;
+}
+
+bool LCollisionMask::loadFromSurface( SDL_Surface* surface )
+{
+	//Get rid of preexisting mask
+	free();
+
+	//Find the color key, if the surface has one
+	Uint32 key;
+	bool keyed = SDL_GetColorKey( surface, &key ) == 0;
+	Uint8 keyR = 0, keyG = 0, keyB = 0;
+	if( keyed )
+	{
+		SDL_GetRGB( key, surface->format, &keyR, &keyG, &keyB );
+	}
+	Uint32 keyRGB = ( keyR << 16 ) | ( keyG << 8 ) | keyB;
+
+	//Read the pixels in a known format
+	SDL_Surface* converted = SDL_ConvertSurfaceFormat( surface, SDL_PIXELFORMAT_ARGB8888, 0 );
+	if( converted == NULL )
+	{
+		printf( "Unable to convert surface for collision mask! SDL Error: %s\n", SDL_GetError() );
+		return false;
+	}
+
+	mWidth = converted->w;
+	mHeight = converted->h;
+	mRowWords = ( mWidth + 63 ) / 64;
+	mBits.assign( (size_t)mRowWords * mHeight, 0 );
+
+	//Set the bit of every solid pixel
+	SDL_LockSurface( converted );
+	for( int y = 0; y < mHeight; ++y )
+	{
+		Uint32* pixels = (Uint32*)( (Uint8*)converted->pixels + y * converted->pitch );
+		Uint64* row = &mBits[ (size_t)y * mRowWords ];
+		for( int x = 0; x < mWidth; ++x )
+		{
+			Uint32 pixel = pixels[ x ];
+			bool solid = ( pixel >> 24 ) >= ALPHA_THRESHOLD;
+			if( keyed && ( pixel & 0x00FFFFFF ) == keyRGB )
+			{
+				solid = false;
+			}
+
+			if( solid )
+			{
+				row[ x / 64 ] |= (Uint64)1 << ( x % 64 );
+			}
+		}
+	}
+	SDL_UnlockSurface( converted );
+
+	SDL_FreeSurface( converted );
+	return true;
+}
+
+void LCollisionMask::free()
+{
+	mBits.clear();
+	mWidth = 0;
+	mHeight = 0;
+	mRowWords = 0;
+}
+
+bool LCollisionMask::isSolid( int x, int y )
+{
+	if( x < 0 || y < 0 || x >= mWidth || y >= mHeight )
+	{
+		return false;
+	}
+
+	return ( mBits[ (size_t)y * mRowWords + x / 64 ] >> ( x % 64 ) ) & 1;
+}
+
+bool LCollisionMask::collides( int x, int y, LCollisionMask& other, int otherX, int otherY )
+{
+	//Bounding box reject
+	int left = SDL_max( x, otherX );
+	int right = SDL_min( x + mWidth, otherX + other.mWidth );
+	int top = SDL_max( y, otherY );
+	int bottom = SDL_min( y + mHeight, otherY + other.mHeight );
+	if( left >= right || top >= bottom )
+	{
+		return false;
+	}
+
+	//AND the overlapping part of each row pair, 64 pixels at a time
+	for( int worldY = top; worldY < bottom; ++worldY )
+	{
+		int row = worldY - y;
+		int otherRow = worldY - otherY;
+		for( int worldX = left; worldX < right; worldX += 64 )
+		{
+			Uint64 bits = getBits( row, worldX - x ) & other.getBits( otherRow, worldX - otherX );
+
+			//Drop the pixels past the overlap in the last chunk
+			int remaining = right - worldX;
+			if( remaining < 64 )
+			{
+				bits &= ( (Uint64)1 << remaining ) - 1;
+			}
+
+			if( bits != 0 )
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+bool LCollisionMask::collides( int x, int y, const SDL_Rect& box )
+{
+	//Bounding box reject
+	int left = SDL_max( x, box.x );
+	int right = SDL_min( x + mWidth, box.x + box.w );
+	int top = SDL_max( y, box.y );
+	int bottom = SDL_min( y + mHeight, box.y + box.h );
+	if( left >= right || top >= bottom )
+	{
+		return false;
+	}
+
+	//Any solid pixel inside the box's columns is a hit
+	for( int worldY = top; worldY < bottom; ++worldY )
+	{
+		for( int worldX = left; worldX < right; worldX += 64 )
+		{
+			Uint64 bits = getBits( worldY - y, worldX - x );
+			int remaining = right - worldX;
+			if( remaining < 64 )
+			{
+				bits &= ( (Uint64)1 << remaining ) - 1;
+			}
+
+			if( bits != 0 )
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+int LCollisionMask::getWidth()
+{
+	return mWidth;
+}
+
+int LCollisionMask::getHeight()
+{
+	return mHeight;
+}
+
+Uint64 LCollisionMask::getBits( int row, int x )
+{
+	//Words are little end first, so a bit offset shifts right and borrows from the next word
+	const Uint64* words = &mBits[ (size_t)row * mRowWords ];
+	int word = x / 64;
+	int shift = x % 64;
+
+	Uint64 bits = words[ word ] >> shift;
+	if( shift != 0 && word + 1 < mRowWords )
+	{
+		bits |= words[ word + 1 ] << ( 64 - shift );
+	}
+
+	return bits;
+}
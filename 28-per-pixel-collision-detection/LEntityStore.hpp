@@ -0,0 +1,284 @@
+//Entity component store
+//Entities are indices into one array per component: position, velocity and
+//collider size. Systems walk the arrays front to back, so a pass touches
+//memory in order and the simple loops can be vectorized. Removing an entity
+//moves the last one into its place to keep the arrays packed
+class LEntityStore
+{
+	public:
+		//Initializes variables
+		LEntityStore();
+
+		//Adds an entity with a collider of width by height at x, y and returns its index
+		int create( int x, int y, int width, int height, int velX, int velY );
+
+		//Removes an entity, the last entity takes its index
+		void destroy( int entity );
+
+		//Removes every entity
+		void clear();
+
+		//Reserves room for count entities
+		void reserve( int count );
+
+		//Gets the number of entities
+		int getCount();
+
+		//Gets an entity's collider
+		SDL_Rect getCollider( int entity );
+
+		//Motion system: moves every entity by its velocity, turning back at the field edges
+		void move( int fieldWidth, int fieldHeight );
+
+		//Moves entities first to last, ranges can run on different threads
+		void move( int fieldWidth, int fieldHeight, int first, int last );
+
+		//Broadphase system: hands every collider to the broadphase, ids are entity indices
+		void updateBroadphase( LSweepAndPrune& broadphase );
+
+		//Collision system: checks broadphase pairs pixel by pixel, all entities sharing mask
+		//Flags colliding entities and returns the number of pairs touching
+		int collide( const std::vector< std::pair<int, int> >& pairs, LCollisionMask& mask, std::vector<Uint8>& colliding );
+
+		//Checks pairs first to last pixel by pixel, setting touching[ pair ], ranges can run on different threads
+		void testPairs( const std::vector< std::pair<int, int> >& pairs, int first, int last, LCollisionMask& mask, Uint8* touching );
+
+		//Flags the entities of touching pairs and returns the number of them
+		int flagColliding( const std::vector< std::pair<int, int> >& pairs, const Uint8* touching, std::vector<Uint8>& colliding );
+
+		//Draw list system: appends entities first to last that overlap view
+		void findVisible( const SDL_Rect& view, int first, int last, std::vector<int>& visible );
+
+		//Component arrays, for systems outside the store
+		int* getPosX();
+		int* getPosY();
+		int* getVelX();
+		int* getVelY();
+		int* getWidth();
+		int* getHeight();
+
+	private:
+		//Pair results kept between collision passes
+		std::vector<Uint8> mTouching;
+
+		//Components
+		std::vector<int> mPosX;
+		std::vector<int> mPosY;
+		std::vector<int> mVelX;
+		std::vector<int> mVelY;
+		std::vector<int> mWidth;
+		std::vector<int> mHeight;
+};
+
+LEntityStore::LEntityStore()
+{
+}
+
+int LEntityStore::create( int x, int y, int width, int height, int velX, int velY )
+{
+	mPosX.push_back( x );
+	mPosY.push_back( y );
+	mVelX.push_back( velX );
+	mVelY.push_back( velY );
+	mWidth.push_back( width );
+	mHeight.push_back( height );
+	return mPosX.size() - 1;
+}
+
+void LEntityStore::destroy( int entity )
+{
+	if( entity < 0 || entity >= mPosX.size() )
+	{
+		return;
+	}
+
+	//Move the last entity into the hole
+	mPosX[ entity ] = mPosX.back();
+	mPosY[ entity ] = mPosY.back();
+	mVelX[ entity ] = mVelX.back();
+	mVelY[ entity ] = mVelY.back();
+	mWidth[ entity ] = mWidth.back();
+	mHeight[ entity ] = mHeight.back();
+
+	mPosX.pop_back();
+	mPosY.pop_back();
+	mVelX.pop_back();
+	mVelY.pop_back();
+	mWidth.pop_back();
+	mHeight.pop_back();
+}
+
+void LEntityStore::clear()
+{
+	mPosX.clear();
+	mPosY.clear();
+	mVelX.clear();
+	mVelY.clear();
+	mWidth.clear();
+	mHeight.clear();
+}
+
+void LEntityStore::reserve( int count )
+{
+	mPosX.reserve( count );
+	mPosY.reserve( count );
+	mVelX.reserve( count );
+	mVelY.reserve( count );
+	mWidth.reserve( count );
+	mHeight.reserve( count );
+}
+
+int LEntityStore::getCount()
+{
+	return mPosX.size();
+}
+
+SDL_Rect LEntityStore::getCollider( int entity )
+{
+	SDL_Rect box = { mPosX[ entity ], mPosY[ entity ], mWidth[ entity ], mHeight[ entity ] };
+	return box;
+}
+
+void LEntityStore::move( int fieldWidth, int fieldHeight )
+{
+	move( fieldWidth, fieldHeight, 0, mPosX.size() );
+}
+
+void LEntityStore::move( int fieldWidth, int fieldHeight, int first, int last )
+{
+	if( first >= last )
+	{
+		return;
+	}
+
+	int* posX = &mPosX[ 0 ];
+	int* posY = &mPosY[ 0 ];
+	int* velX = &mVelX[ 0 ];
+	int* velY = &mVelY[ 0 ];
+	const int* width = &mWidth[ 0 ];
+	const int* height = &mHeight[ 0 ];
+
+	//No branches on the data, so the compiler can do several entities per instruction
+	for( int i = first; i < last; ++i )
+	{
+		int x = posX[ i ] + velX[ i ];
+		int maxX = fieldWidth - width[ i ];
+		bool outX = x < 0 || x > maxX;
+		velX[ i ] = outX ? -velX[ i ] : velX[ i ];
+		posX[ i ] = x < 0 ? 0 : x > maxX ? maxX : x;
+
+		int y = posY[ i ] + velY[ i ];
+		int maxY = fieldHeight - height[ i ];
+		bool outY = y < 0 || y > maxY;
+		velY[ i ] = outY ? -velY[ i ] : velY[ i ];
+		posY[ i ] = y < 0 ? 0 : y > maxY ? maxY : y;
+	}
+}
+
+void LEntityStore::updateBroadphase( LSweepAndPrune& broadphase )
+{
+	//Boxes past the last entity belonged to destroyed ones
+	int count = mPosX.size();
+	for( int id = broadphase.getCount() - 1; id >= count; --id )
+	{
+		broadphase.remove( id );
+	}
+
+	//Entities created since the last pass are new to the broadphase
+	for( int i = 0; i < count; ++i )
+	{
+		SDL_Rect box = { mPosX[ i ], mPosY[ i ], mWidth[ i ], mHeight[ i ] };
+		if( i < broadphase.getCount() )
+		{
+			broadphase.update( i, box );
+		}
+		else
+		{
+			broadphase.insert( box );
+		}
+	}
+}
+
+int LEntityStore::collide( const std::vector< std::pair<int, int> >& pairs, LCollisionMask& mask, std::vector<Uint8>& colliding )
+{
+	mTouching.resize( pairs.size() );
+	if( pairs.empty() )
+	{
+		colliding.assign( mPosX.size(), 0 );
+		return 0;
+	}
+
+	testPairs( pairs, 0, pairs.size(), mask, &mTouching[ 0 ] );
+	return flagColliding( pairs, &mTouching[ 0 ], colliding );
+}
+
+void LEntityStore::testPairs( const std::vector< std::pair<int, int> >& pairs, int first, int last, LCollisionMask& mask, Uint8* touching )
+{
+	for( int i = first; i < last; ++i )
+	{
+		int a = pairs[ i ].first;
+		int b = pairs[ i ].second;
+		touching[ i ] = mask.collides( mPosX[ a ], mPosY[ a ], mask, mPosX[ b ], mPosY[ b ] );
+	}
+}
+
+int LEntityStore::flagColliding( const std::vector< std::pair<int, int> >& pairs, const Uint8* touching, std::vector<Uint8>& colliding )
+{
+	colliding.assign( mPosX.size(), 0 );
+
+	int hits = 0;
+	for( int i = 0; i < pairs.size(); ++i )
+	{
+		if( touching[ i ] )
+		{
+			colliding[ pairs[ i ].first ] = 1;
+			colliding[ pairs[ i ].second ] = 1;
+			++hits;
+		}
+	}
+
+	return hits;
+}
+
+void LEntityStore::findVisible( const SDL_Rect& view, int first, int last, std::vector<int>& visible )
+{
+	int viewRight = view.x + view.w;
+	int viewBottom = view.y + view.h;
+	for( int i = first; i < last; ++i )
+	{
+		if( mPosX[ i ] < viewRight && view.x < mPosX[ i ] + mWidth[ i ] && mPosY[ i ] < viewBottom && view.y < mPosY[ i ] + mHeight[ i ] )
+		{
+			visible.push_back( i );
+		}
+	}
+}
+
+int* LEntityStore::getPosX()
+{
+	return mPosX.empty() ? NULL : &mPosX[ 0 ];
+}
+
+int* LEntityStore::getPosY()
+{
+	return mPosY.empty() ? NULL : &mPosY[ 0 ];
+}
+
+int* LEntityStore::getVelX()
+{
+	return mVelX.empty() ? NULL : &mVelX[ 0 ];
+}
+
+int* LEntityStore::getVelY()
+{
+	return mVelY.empty() ? NULL : &mVelY[ 0 ];
+}
+
+int* LEntityStore::getWidth()
+{
+	return mWidth.empty() ? NULL : &mWidth[ 0 ];
+}
+
+int* LEntityStore::getHeight()
+{
+	return mHeight.empty() ? NULL : &mHeight[ 0 ];
+}
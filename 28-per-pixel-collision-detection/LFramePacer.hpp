@@ -0,0 +1,164 @@
+//Frame pacer holding a steady frame rate
+//Frame deadlines are absolute performance counter times computed from the
+//frame number, so rounding never accumulates and a late frame doesn't push
+//back the ones after it. Waiting sleeps while the deadline is far off, then
+//yields for the last stretch, which is sized from how much SDL_Delay has
+//been observed to oversleep
+class LFramePacer
+{
+	public:
+		//Initializes variables
+		LFramePacer( int framesPerSecond );
+
+		//Starts pacing from the current time
+		void start();
+
+		//Waits for the next frame's deadline
+		void wait();
+
+		//Gets pacing statistics in nanoseconds, error is how late frames were released
+		double getMeanError();
+		double getJitter();
+		double getMaxError();
+
+		//Gets how many deadlines were missed by more than a frame
+		Uint64 getMissedFrames();
+
+		//Clears the pacing statistics
+		void resetStats();
+
+	private:
+		//Gets the counter value the given frame is due at
+		Uint64 getDeadline( Uint64 frame );
+
+		//Frames per second and the counter frequency
+		Uint64 mFramesPerSecond;
+		Uint64 mFrequency;
+
+		//The counter value frame 0 was due at and the frame being waited for
+		Uint64 mStartCounter;
+		Uint64 mFrame;
+
+		//Estimated SDL_Delay oversleep in counter ticks
+		Uint64 mSleepSlack;
+
+		//Running error statistics
+		Uint64 mSamples;
+		double mMeanError;
+		double mErrorSquares;
+		double mMaxError;
+		Uint64 mMissedFrames;
+};
+
+LFramePacer::LFramePacer( int framesPerSecond )
+{
+	//Initialize
+	mFramesPerSecond = framesPerSecond > 0 ? framesPerSecond : 60;
+	mFrequency = SDL_GetPerformanceFrequency();
+	mStartCounter = SDL_GetPerformanceCounter();
+	mFrame = 0;
+
+	//Assume a scheduler quantum until measured
+	mSleepSlack = mFrequency / 500;
+
+	resetStats();
+}
+
+void LFramePacer::start()
+{
+	mStartCounter = SDL_GetPerformanceCounter();
+	mFrame = 0;
+}
+
+void LFramePacer::wait()
+{
+	Uint64 deadline = getDeadline( mFrame + 1 );
+	Uint64 period = mFrequency / mFramesPerSecond;
+	Uint64 now = SDL_GetPerformanceCounter();
+
+	//Sleep through most of the wait, leaving the expected oversleep
+	if( now + mSleepSlack < deadline )
+	{
+		Uint64 requested = ( deadline - now - mSleepSlack ) * 1000 / mFrequency;
+		if( requested > 0 )
+		{
+			SDL_Delay( (Uint32)requested );
+
+			//Track the worst recent oversleep, decaying slowly so one hiccup doesn't stick
+			Uint64 slept = SDL_GetPerformanceCounter() - now;
+			Uint64 wanted = requested * mFrequency / 1000;
+			Uint64 oversleep = slept > wanted ? slept - wanted : 0;
+			mSleepSlack -= mSleepSlack / 64;
+			if( oversleep > mSleepSlack )
+			{
+				mSleepSlack = oversleep;
+			}
+		}
+	}
+
+	//Yield the rest of the way to the deadline
+	now = SDL_GetPerformanceCounter();
+	while( now < deadline )
+	{
+		SDL_Delay( 0 );
+		now = SDL_GetPerformanceCounter();
+	}
+
+	//Record how late the frame was released
+	double error = ( now - deadline ) * 1e9 / mFrequency;
+	++mSamples;
+	double delta = error - mMeanError;
+	mMeanError += delta / mSamples;
+	mErrorSquares += delta * ( error - mMeanError );
+	if( error > mMaxError )
+	{
+		mMaxError = error;
+	}
+
+	//A frame ran long: start a new schedule instead of rushing to catch up
+	if( now - deadline > period )
+	{
+		++mMissedFrames;
+		mStartCounter = now;
+		mFrame = 0;
+	}
+	else
+	{
+		++mFrame;
+	}
+}
+
+double LFramePacer::getMeanError()
+{
+	return mMeanError;
+}
+
+double LFramePacer::getJitter()
+{
+	return mSamples > 1 ? SDL_sqrt( mErrorSquares / ( mSamples - 1 ) ) : 0.0;
+}
+
+double LFramePacer::getMaxError()
+{
+	return mMaxError;
+}
+
+Uint64 LFramePacer::getMissedFrames()
+{
+	return mMissedFrames;
+}
+
+void LFramePacer::resetStats()
+{
+	mSamples = 0;
+	mMeanError = 0.0;
+	mErrorSquares = 0.0;
+	mMaxError = 0.0;
+	mMissedFrames = 0;
+}
+
+Uint64 LFramePacer::getDeadline( Uint64 frame )
+{
+	//Whole seconds first so the exact frame time can't overflow
+	return mStartCounter + frame / mFramesPerSecond * mFrequency + frame % mFramesPerSecond * mFrequency / mFramesPerSecond;
+}
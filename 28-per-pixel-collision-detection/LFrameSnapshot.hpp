@@ -0,0 +1,145 @@
+//Frame snapshot
+//Everything needed to draw one frame, copied out of the simulation so it can
+//be drawn on another thread while the simulation moves on. Sprites point at
+//their textures, which belong to the render thread and have to outlive any
+//snapshot that uses them
+class LFrameSnapshot
+{
+	public:
+		//Initializes variables
+		LFrameSnapshot();
+
+		//Starts a new frame cleared to the given color, keeping the memory of the last one
+		void reset( Uint8 red = 0xFF, Uint8 green = 0xFF, Uint8 blue = 0xFF );
+
+		//Sets the color that sprites and rectangles added after it are drawn in
+		void setColor( Uint8 red, Uint8 green, Uint8 blue, Uint8 alpha = 0xFF );
+
+		//Adds rectangle outlines
+		void addRects( const SDL_Rect* rects, int count );
+
+		//Adds a texture drawn at x, y, taking the same arguments as LTexture::render
+		void addSprite( LTexture* texture, int x, int y, SDL_Rect* clip = NULL, double angle = 0.0, SDL_RendererFlip flip = SDL_FLIP_NONE );
+
+		//Draws the frame, from the thread that owns renderer
+		void render( SDL_Renderer* renderer );
+
+		//Gets the number of sprites in the frame
+		int getSpriteCount();
+
+	private:
+		//A texture to draw and how
+		struct Sprite
+		{
+			LTexture* texture;
+			int x;
+			int y;
+			SDL_Rect clip;
+			bool clipped;
+			double angle;
+			SDL_RendererFlip flip;
+			SDL_Color color;
+		};
+
+		//A run of rectangle outlines sharing a color
+		struct RectRun
+		{
+			int first;
+			int count;
+			SDL_Color color;
+		};
+
+		//Color the frame is cleared to and the one being added with
+		SDL_Color mBackground;
+		SDL_Color mColor;
+
+		//Draw lists, rectangles go under the sprites
+		std::vector<SDL_Rect> mRects;
+		std::vector<RectRun> mRectRuns;
+		std::vector<Sprite> mSprites;
+};
+
+LFrameSnapshot::LFrameSnapshot()
+{
+	//Initialize
+	reset();
+}
+
+void LFrameSnapshot::reset( Uint8 red, Uint8 green, Uint8 blue )
+{
+	mBackground.r = red;
+	mBackground.g = green;
+	mBackground.b = blue;
+	mBackground.a = 0xFF;
+	setColor( 0xFF, 0xFF, 0xFF );
+
+	mRects.clear();
+	mRectRuns.clear();
+	mSprites.clear();
+}
+
+void LFrameSnapshot::setColor( Uint8 red, Uint8 green, Uint8 blue, Uint8 alpha )
+{
+	mColor.r = red;
+	mColor.g = green;
+	mColor.b = blue;
+	mColor.a = alpha;
+}
+
+void LFrameSnapshot::addRects( const SDL_Rect* rects, int count )
+{
+	if( count <= 0 )
+	{
+		return;
+	}
+
+	RectRun run = { (int)mRects.size(), count, mColor };
+	mRectRuns.push_back( run );
+	mRects.insert( mRects.end(), rects, rects + count );
+}
+
+void LFrameSnapshot::addSprite( LTexture* texture, int x, int y, SDL_Rect* clip, double angle, SDL_RendererFlip flip )
+{
+	Sprite sprite;
+	sprite.texture = texture;
+	sprite.x = x;
+	sprite.y = y;
+	sprite.clipped = clip != NULL;
+	if( sprite.clipped )
+	{
+		sprite.clip = *clip;
+	}
+	sprite.angle = angle;
+	sprite.flip = flip;
+	sprite.color = mColor;
+	mSprites.push_back( sprite );
+}
+
+void LFrameSnapshot::render( SDL_Renderer* renderer )
+{
+	//Clear screen
+	SDL_SetRenderDrawColor( renderer, mBackground.r, mBackground.g, mBackground.b, mBackground.a );
+	SDL_RenderClear( renderer );
+
+	//Outlines one batch per color
+	for( int i = 0; i < mRectRuns.size(); ++i )
+	{
+		const RectRun& run = mRectRuns[ i ];
+		SDL_SetRenderDrawColor( renderer, run.color.r, run.color.g, run.color.b, run.color.a );
+		SDL_RenderDrawRects( renderer, &mRects[ run.first ], run.count );
+	}
+
+	//Sprites in the order they were added
+	for( int i = 0; i < mSprites.size(); ++i )
+	{
+		Sprite& sprite = mSprites[ i ];
+		sprite.texture->setColor( sprite.color.r, sprite.color.g, sprite.color.b );
+		sprite.texture->setAlpha( sprite.color.a );
+		sprite.texture->render( sprite.x, sprite.y, sprite.clipped ? &sprite.clip : NULL, sprite.angle, NULL, sprite.flip );
+	}
+}
+
+int LFrameSnapshot::getSpriteCount()
+{
+	return mSprites.size();
+}
@@ -0,0 +1,389 @@
+//Work stealing job system
+//Every thread owns a deque of jobs. It pushes and pops its own work at the
+//bottom, newest first while it's still in cache, and idle threads steal the
+//oldest job from the top of someone else's. A job may have a parent, which
+//isn't finished until all its children are, so waiting on a parent waits on
+//the whole tree; a waiting thread runs jobs instead of blocking.
+//Jobs come from a fixed ring per thread, so creating one never allocates, but
+//no more than JOBS_PER_THREAD of one thread's jobs can be in flight at once.
+//Only the thread that called start and the workers may create jobs
+class LJobSystem
+{
+	public:
+		//Jobs each thread can have in flight, a power of two
+		static const int JOBS_PER_THREAD = 4096;
+
+		//Work done by a job, on items begin to end of whatever data points to
+		typedef void (*JobFunction)( void* data, int begin, int end );
+
+		//A unit of work
+		struct Job
+		{
+			JobFunction function;
+			void* data;
+			int begin;
+			int end;
+			Job* parent;
+			SDL_atomic_t unfinished;
+		};
+
+		//Initializes variables
+		LJobSystem();
+
+		//Stops the workers
+		~LJobSystem();
+
+		//Starts worker threads, by default one less than the number of cores
+		bool start( int workers = -1 );
+
+		//Finishes queued jobs and stops the workers
+		void stop();
+
+		//Makes a job, parent can't finish before it; function may be NULL for a job that only groups others
+		Job* create( JobFunction function, void* data, int begin = 0, int end = 0, Job* parent = NULL );
+
+		//Queues a job on the calling thread's deque
+		void run( Job* job );
+
+		//Runs other jobs until job and its children are finished
+		void wait( Job* job );
+
+		//Checks whether job and its children are finished
+		bool isFinished( Job* job );
+
+		//Calls function on items 0 to count in slices of about grain items spread over every thread, and waits for them
+		void parallelFor( JobFunction function, void* data, int count, int grain );
+
+		//Gets the number of threads running jobs, the starting thread included
+		int getThreadCount();
+
+		//Gets the calling thread's index, 0 for the thread that called start
+		static int getThreadIndex();
+
+	private:
+		//A thread's jobs and the deque they are queued on
+		struct Worker
+		{
+			Job jobs[ JOBS_PER_THREAD ];
+			int nextJob;
+			Job* deque[ JOBS_PER_THREAD ];
+			int top;
+			int bottom;
+			SDL_SpinLock lock;
+			SDL_Thread* thread;
+			LJobSystem* system;
+			int index;
+		};
+
+		//Worker thread body
+		static int workerMain( void* data );
+
+		//Takes a job from the calling thread's deque or steals one, NULL if there's no work
+		Job* getJob();
+
+		//Runs a job and marks it finished
+		void execute( Job* job );
+
+		//Marks a job done, finishing its parent once that has no children left
+		void finish( Job* job );
+
+		//Every thread's state, the starting thread is first
+		std::vector<Worker*> mWorkers;
+
+		//Wakes sleeping workers when jobs are queued
+		SDL_sem* mWake;
+
+		//Cleared to stop the workers
+		SDL_atomic_t mRunning;
+
+		//Index of the calling thread
+		static thread_local int sThreadIndex;
+};
+
+thread_local int LJobSystem::sThreadIndex = 0;
+
+LJobSystem::LJobSystem()
+{
+	//Initialize
+	mWake = NULL;
+	SDL_AtomicSet( &mRunning, 0 );
+}
+
+LJobSystem::~LJobSystem()
+{
+	stop();
+}
+
+bool LJobSystem::start( int workers )
+{
+	stop();
+
+	if( workers < 0 )
+	{
+		workers = SDL_max( SDL_GetCPUCount() - 1, 0 );
+	}
+
+	mWake = SDL_CreateSemaphore( 0 );
+	if( mWake == NULL )
+	{
+		printf( "Unable to create job semaphore! SDL Error: %s\n", SDL_GetError() );
+		return false;
+	}
+
+	//The calling thread is worker 0
+	SDL_AtomicSet( &mRunning, 1 );
+	sThreadIndex = 0;
+	for( int i = 0; i <= workers; ++i )
+	{
+		Worker* worker = new Worker;
+		worker->nextJob = 0;
+		worker->top = 0;
+		worker->bottom = 0;
+		worker->lock = 0;
+		worker->thread = NULL;
+		worker->system = this;
+		worker->index = i;
+		mWorkers.push_back( worker );
+	}
+
+	for( int i = 1; i <= workers; ++i )
+	{
+		mWorkers[ i ]->thread = SDL_CreateThread( workerMain, "job worker", mWorkers[ i ] );
+		if( mWorkers[ i ]->thread == NULL )
+		{
+			printf( "Unable to create job worker! SDL Error: %s\n", SDL_GetError() );
+			stop();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void LJobSystem::stop()
+{
+	if( mWorkers.empty() )
+	{
+		return;
+	}
+
+	//Run what's left, then let the workers see they're done
+	while( Job* job = getJob() )
+	{
+		execute( job );
+	}
+
+	SDL_AtomicSet( &mRunning, 0 );
+	for( int i = 1; i < mWorkers.size(); ++i )
+	{
+		SDL_SemPost( mWake );
+	}
+
+	//Workers may still be looking through each other's deques until they've all quit
+	for( int i = 0; i < mWorkers.size(); ++i )
+	{
+		if( mWorkers[ i ]->thread != NULL )
+		{
+			SDL_WaitThread( mWorkers[ i ]->thread, NULL );
+		}
+	}
+
+	for( int i = 0; i < mWorkers.size(); ++i )
+	{
+		delete mWorkers[ i ];
+	}
+	mWorkers.clear();
+
+	SDL_DestroySemaphore( mWake );
+	mWake = NULL;
+}
+
+LJobSystem::Job* LJobSystem::create( JobFunction function, void* data, int begin, int end, Job* parent )
+{
+	//Take the next job in the calling thread's ring
+	Worker* worker = mWorkers[ sThreadIndex ];
+	Job* job = &worker->jobs[ worker->nextJob ];
+	worker->nextJob = ( worker->nextJob + 1 ) & ( JOBS_PER_THREAD - 1 );
+
+	job->function = function;
+	job->data = data;
+	job->begin = begin;
+	job->end = end;
+	job->parent = parent;
+	SDL_AtomicSet( &job->unfinished, 1 );
+
+	//The parent now waits on one more child
+	if( parent != NULL )
+	{
+		SDL_AtomicIncRef( &parent->unfinished );
+	}
+
+	return job;
+}
+
+void LJobSystem::run( Job* job )
+{
+	//A full deque can't take more, run the job here instead
+	Worker* worker = mWorkers[ sThreadIndex ];
+	SDL_AtomicLock( &worker->lock );
+	bool queued = worker->bottom - worker->top < JOBS_PER_THREAD;
+	if( queued )
+	{
+		worker->deque[ worker->bottom & ( JOBS_PER_THREAD - 1 ) ] = job;
+		++worker->bottom;
+	}
+	SDL_AtomicUnlock( &worker->lock );
+
+	if( queued )
+	{
+		SDL_SemPost( mWake );
+	}
+	else
+	{
+		execute( job );
+	}
+}
+
+void LJobSystem::wait( Job* job )
+{
+	while( !isFinished( job ) )
+	{
+		Job* next = getJob();
+		if( next != NULL )
+		{
+			execute( next );
+		}
+		else
+		{
+			//Someone else is running the last of it
+			SDL_Delay( 0 );
+		}
+	}
+}
+
+bool LJobSystem::isFinished( Job* job )
+{
+	return SDL_AtomicGet( &job->unfinished ) == 0;
+}
+
+void LJobSystem::parallelFor( JobFunction function, void* data, int count, int grain )
+{
+	if( count <= 0 )
+	{
+		return;
+	}
+
+	//Without workers there's nothing to spread over
+	if( mWorkers.size() <= 1 )
+	{
+		function( data, 0, count );
+		return;
+	}
+
+	//One slice per child of a root that only groups them, at most half a ring of them
+	grain = SDL_max( grain, 1 );
+	grain = SDL_max( grain, ( count + JOBS_PER_THREAD / 2 - 1 ) / ( JOBS_PER_THREAD / 2 ) );
+	Job* root = create( NULL, NULL );
+	for( int begin = 0; begin < count; begin += grain )
+	{
+		run( create( function, data, begin, SDL_min( begin + grain, count ), root ) );
+	}
+
+	//The root has nothing of its own to do
+	finish( root );
+	wait( root );
+}
+
+int LJobSystem::getThreadCount()
+{
+	return SDL_max( (int)mWorkers.size(), 1 );
+}
+
+int LJobSystem::getThreadIndex()
+{
+	return sThreadIndex;
+}
+
+int LJobSystem::workerMain( void* data )
+{
+	Worker* worker = (Worker*)data;
+	LJobSystem* system = worker->system;
+	sThreadIndex = worker->index;
+
+	while( SDL_AtomicGet( &system->mRunning ) )
+	{
+		Job* job = system->getJob();
+		if( job != NULL )
+		{
+			system->execute( job );
+		}
+		else
+		{
+			//Sleep until jobs are queued, checking now and then in case a wake up was taken by another worker
+			SDL_SemWaitTimeout( system->mWake, 1 );
+		}
+	}
+
+	return 0;
+}
+
+LJobSystem::Job* LJobSystem::getJob()
+{
+	if( mWorkers.empty() )
+	{
+		return NULL;
+	}
+
+	//Own jobs newest first
+	Worker* worker = mWorkers[ sThreadIndex ];
+	Job* job = NULL;
+	SDL_AtomicLock( &worker->lock );
+	if( worker->bottom != worker->top )
+	{
+		--worker->bottom;
+		job = worker->deque[ worker->bottom & ( JOBS_PER_THREAD - 1 ) ];
+	}
+	SDL_AtomicUnlock( &worker->lock );
+	if( job != NULL )
+	{
+		return job;
+	}
+
+	//Otherwise steal the oldest job of the next thread that has one
+	for( int i = 1; i < mWorkers.size(); ++i )
+	{
+		Worker* victim = mWorkers[ ( sThreadIndex + i ) % mWorkers.size() ];
+		SDL_AtomicLock( &victim->lock );
+		if( victim->bottom != victim->top )
+		{
+			job = victim->deque[ victim->top & ( JOBS_PER_THREAD - 1 ) ];
+			++victim->top;
+		}
+		SDL_AtomicUnlock( &victim->lock );
+		if( job != NULL )
+		{
+			return job;
+		}
+	}
+
+	return NULL;
+}
+
+void LJobSystem::execute( Job* job )
+{
+	if( job->function != NULL )
+	{
+		job->function( job->data, job->begin, job->end );
+	}
+	finish( job );
+}
+
+void LJobSystem::finish( Job* job )
+{
+	//The last one out finishes the parent, the job may be reused as soon as it's finished
+	Job* parent = job->parent;
+	if( SDL_AtomicAdd( &job->unfinished, -1 ) == 1 && parent != NULL )
+	{
+		finish( parent );
+	}
+}
@@ -0,0 +1,268 @@
+//Render thread
+//Owns the renderer and draws frame snapshots the simulation publishes, so a
+//present waiting on vsync never holds up input or the next update. Three
+//snapshots rotate between the two threads: the simulation fills the back
+//one, the render thread draws the front one and the middle one is the
+//latest published. Publishing and picking up both swap with the middle in
+//one atomic exchange, so neither side ever waits on the other, and a
+//snapshot the render thread was too slow to pick up is simply replaced.
+//SDL only takes events on the main thread, which keeps the window; the
+//renderer and its textures are created, used and freed on the render thread
+class LRenderThread
+{
+	public:
+		//Loads textures for the renderer, on the render thread
+		typedef bool (*LoadFunction)( SDL_Renderer* renderer );
+
+		//Frees them again before the renderer goes
+		typedef void (*FreeFunction)();
+
+		//Initializes variables
+		LRenderThread();
+
+		//Stops the thread
+		~LRenderThread();
+
+		//Creates a renderer for window with the given flags on a new thread, loads media there and starts drawing
+		bool start( SDL_Window* window, Uint32 flags, LoadFunction load, FreeFunction free );
+
+		//Frees media and the renderer and ends the thread
+		void stop();
+
+		//Gets the snapshot the simulation fills next, it isn't drawn until published
+		LFrameSnapshot& getSnapshot();
+
+		//Hands the filled snapshot to the render thread, replacing one it hasn't picked up yet
+		void publish();
+
+		//Gets the number of frames presented
+		int getFramesPresented();
+
+		//Gets the number of published snapshots replaced before they were drawn
+		int getSnapshotsDropped();
+
+	private:
+		//Marks the middle snapshot as published and not yet picked up
+		static const int FRESH = 4;
+
+		//Render thread body
+		static int renderMain( void* data );
+
+		//Swaps the front snapshot for the middle one if a newer one was published
+		bool acquire();
+
+		//The window drawn to and how its renderer is made
+		SDL_Window* mWindow;
+		Uint32 mFlags;
+		LoadFunction mLoad;
+		FreeFunction mFree;
+
+		//The renderer, only touched on the render thread
+		SDL_Renderer* mRenderer;
+
+		//Thread handle and run flag
+		SDL_Thread* mThread;
+		SDL_atomic_t mRunning;
+
+		//Signalled once the renderer and media are ready, and on every publish
+		SDL_sem* mReady;
+		SDL_sem* mPublished;
+		bool mStarted;
+
+		//Snapshot buffers, the middle index carries the fresh flag
+		LFrameSnapshot mSnapshots[ 3 ];
+		int mBack;
+		int mFront;
+		SDL_atomic_t mMiddle;
+
+		//Statistics
+		SDL_atomic_t mFramesPresented;
+		int mSnapshotsDropped;
+};
+
+LRenderThread::LRenderThread()
+{
+	//Initialize
+	mWindow = NULL;
+	mFlags = 0;
+	mLoad = NULL;
+	mFree = NULL;
+	mRenderer = NULL;
+	mThread = NULL;
+	SDL_AtomicSet( &mRunning, 0 );
+	mReady = NULL;
+	mPublished = NULL;
+	mStarted = false;
+	mBack = 0;
+	mFront = 1;
+	SDL_AtomicSet( &mMiddle, 2 );
+	SDL_AtomicSet( &mFramesPresented, 0 );
+	mSnapshotsDropped = 0;
+}
+
+LRenderThread::~LRenderThread()
+{
+	stop();
+}
+
+bool LRenderThread::start( SDL_Window* window, Uint32 flags, LoadFunction load, FreeFunction free )
+{
+	stop();
+
+	mWindow = window;
+	mFlags = flags;
+	mLoad = load;
+	mFree = free;
+
+	mReady = SDL_CreateSemaphore( 0 );
+	mPublished = SDL_CreateSemaphore( 0 );
+	if( mReady == NULL || mPublished == NULL )
+	{
+		printf( "Unable to create render semaphores! SDL Error: %s\n", SDL_GetError() );
+		stop();
+		return false;
+	}
+
+	//Nothing is published yet
+	mBack = 0;
+	mFront = 1;
+	SDL_AtomicSet( &mMiddle, 2 );
+	mSnapshots[ mBack ].reset();
+
+	SDL_AtomicSet( &mRunning, 1 );
+	mThread = SDL_CreateThread( renderMain, "render", this );
+	if( mThread == NULL )
+	{
+		printf( "Unable to create render thread! SDL Error: %s\n", SDL_GetError() );
+		stop();
+		return false;
+	}
+
+	//The thread says whether the renderer and media came up
+	SDL_SemWait( mReady );
+	if( !mStarted )
+	{
+		stop();
+		return false;
+	}
+
+	return true;
+}
+
+void LRenderThread::stop()
+{
+	//Let the thread see it's done
+	SDL_AtomicSet( &mRunning, 0 );
+	if( mThread != NULL )
+	{
+		SDL_SemPost( mPublished );
+		SDL_WaitThread( mThread, NULL );
+		mThread = NULL;
+	}
+	mStarted = false;
+
+	SDL_DestroySemaphore( mReady );
+	SDL_DestroySemaphore( mPublished );
+	mReady = NULL;
+	mPublished = NULL;
+}
+
+LFrameSnapshot& LRenderThread::getSnapshot()
+{
+	return mSnapshots[ mBack ];
+}
+
+void LRenderThread::publish()
+{
+	//Everything written to the snapshot has to land before the render thread can see it
+	SDL_MemoryBarrierRelease();
+	int old = SDL_AtomicSet( &mMiddle, mBack | FRESH );
+	if( old & FRESH )
+	{
+		++mSnapshotsDropped;
+	}
+
+	//Fill whatever came back next
+	mBack = old & ~FRESH;
+	mSnapshots[ mBack ].reset();
+	SDL_SemPost( mPublished );
+}
+
+int LRenderThread::getFramesPresented()
+{
+	return SDL_AtomicGet( &mFramesPresented );
+}
+
+int LRenderThread::getSnapshotsDropped()
+{
+	return mSnapshotsDropped;
+}
+
+int LRenderThread::renderMain( void* data )
+{
+	LRenderThread* thread = (LRenderThread*)data;
+
+	//The renderer lives and dies on this thread
+	bool started = false;
+	thread->mRenderer = SDL_CreateRenderer( thread->mWindow, -1, thread->mFlags );
+	if( thread->mRenderer == NULL )
+	{
+		printf( "Renderer could not be created! SDL Error: %s\n", SDL_GetError() );
+	}
+	else if( !thread->mLoad( thread->mRenderer ) )
+	{
+		printf( "Failed to load media on the render thread!\n" );
+		if( thread->mFree != NULL )
+		{
+			thread->mFree();
+		}
+		SDL_DestroyRenderer( thread->mRenderer );
+		thread->mRenderer = NULL;
+	}
+	else
+	{
+		started = true;
+	}
+
+	thread->mStarted = started;
+	SDL_SemPost( thread->mReady );
+	if( !started )
+	{
+		return 0;
+	}
+
+	while( SDL_AtomicGet( &thread->mRunning ) )
+	{
+		//Sleep until something is published, only drawing new snapshots
+		SDL_SemWaitTimeout( thread->mPublished, 100 );
+		if( thread->acquire() )
+		{
+			thread->mSnapshots[ thread->mFront ].render( thread->mRenderer );
+			SDL_RenderPresent( thread->mRenderer );
+			SDL_AtomicIncRef( &thread->mFramesPresented );
+		}
+	}
+
+	//Textures go before their renderer
+	if( thread->mFree != NULL )
+	{
+		thread->mFree();
+	}
+	SDL_DestroyRenderer( thread->mRenderer );
+	thread->mRenderer = NULL;
+
+	return 0;
+}
+
+bool LRenderThread::acquire()
+{
+	if( !( SDL_AtomicGet( &mMiddle ) & FRESH ) )
+	{
+		return false;
+	}
+
+	//Hand back the drawn snapshot for the newest one
+	mFront = SDL_AtomicSet( &mMiddle, mFront ) & ~FRESH;
+	SDL_MemoryBarrierAcquire();
+	return true;
+}
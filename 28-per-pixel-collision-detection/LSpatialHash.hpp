@@ -0,0 +1,304 @@
+//Uniform grid spatial hash over collision boxes
+//Every box is listed in each grid cell it touches, cells are found through a
+//hash of their coordinates so the world needs no bounds. Moving a box only
+//touches the cell lists when it crosses into different cells
+class LSpatialHash
+{
+	public:
+		//Initializes variables, cells should be a bit larger than typical boxes
+		LSpatialHash( int cellSize = 64 );
+
+		//Adds a box and returns its id, owner tags boxes that belong together
+		int insert( const SDL_Rect& box, const void* owner = NULL );
+
+		//Moves a box
+		void update( int id, const SDL_Rect& box );
+
+		//Removes a box, its id may be handed out again
+		void remove( int id );
+
+		//Removes every box
+		void clear();
+
+		//Gets a box and its owner
+		const SDL_Rect& getBox( int id );
+		const void* getOwner( int id );
+
+		//Collects the ids of boxes overlapping area, skipping ignoreOwner's boxes if it isn't NULL
+		void query( const SDL_Rect& area, std::vector<int>& found, const void* ignoreOwner = NULL );
+
+		//Checks whether any box overlaps area, skipping ignoreOwner's boxes if it isn't NULL
+		bool overlaps( const SDL_Rect& area, const void* ignoreOwner = NULL );
+
+		//Gets the number of boxes
+		int getCount();
+
+	private:
+		//A box and the cells it is listed in
+		struct Item
+		{
+			SDL_Rect box;
+			const void* owner;
+			int x0, y0, x1, y1;
+			Uint32 stamp;
+			bool used;
+		};
+
+		//Gets the cells a box touches, empty boxes get an empty range
+		void getCellRange( const SDL_Rect& box, int& x0, int& y0, int& x1, int& y1 );
+
+		//Gets the hash key of a cell
+		static Uint64 getCellKey( int cx, int cy );
+
+		//Adds or removes an item in the cells of its range
+		void link( int id );
+		void unlink( int id );
+
+		//Starts a query so each box is reported once
+		Uint32 nextStamp();
+
+		//Width and height of a cell
+		int mCellSize;
+
+		//Ids of the boxes in each cell
+		std::unordered_map<Uint64, std::vector<int> > mCells;
+
+		//Boxes by id and ids free for reuse
+		std::vector<Item> mItems;
+		std::vector<int> mFreeIds;
+		int mCount;
+
+		//Stamp of the current query
+		Uint32 mStamp;
+};
+
+LSpatialHash::LSpatialHash( int cellSize )
+{
+	//Initialize
+	mCellSize = cellSize > 0 ? cellSize : 64;
+	mCount = 0;
+	mStamp = 0;
+}
+
+int LSpatialHash::insert( const SDL_Rect& box, const void* owner )
+{
+	//Reuse a free id if there is one
+	int id;
+	if( !mFreeIds.empty() )
+	{
+		id = mFreeIds.back();
+		mFreeIds.pop_back();
+	}
+	else
+	{
+		id = mItems.size();
+		mItems.push_back( Item() );
+	}
+
+	Item& item = mItems[ id ];
+	item.box = box;
+	item.owner = owner;
+	item.stamp = 0;
+	item.used = true;
+	getCellRange( box, item.x0, item.y0, item.x1, item.y1 );
+	link( id );
+
+	++mCount;
+	return id;
+}
+
+void LSpatialHash::update( int id, const SDL_Rect& box )
+{
+	Item& item = mItems[ id ];
+	item.box = box;
+
+	//Only relist the box when it moved into different cells
+	int x0, y0, x1, y1;
+	getCellRange( box, x0, y0, x1, y1 );
+	if( x0 != item.x0 || y0 != item.y0 || x1 != item.x1 || y1 != item.y1 )
+	{
+		unlink( id );
+		item.x0 = x0;
+		item.y0 = y0;
+		item.x1 = x1;
+		item.y1 = y1;
+		link( id );
+	}
+}
+
+void LSpatialHash::remove( int id )
+{
+	if( id < 0 || id >= mItems.size() || !mItems[ id ].used )
+	{
+		return;
+	}
+
+	unlink( id );
+	mItems[ id ].used = false;
+	mFreeIds.push_back( id );
+	--mCount;
+}
+
+void LSpatialHash::clear()
+{
+	mCells.clear();
+	mItems.clear();
+	mFreeIds.clear();
+	mCount = 0;
+}
+
+const SDL_Rect& LSpatialHash::getBox( int id )
+{
+	return mItems[ id ].box;
+}
+
+const void* LSpatialHash::getOwner( int id )
+{
+	return mItems[ id ].owner;
+}
+
+void LSpatialHash::query( const SDL_Rect& area, std::vector<int>& found, const void* ignoreOwner )
+{
+	found.clear();
+
+	int x0, y0, x1, y1;
+	getCellRange( area, x0, y0, x1, y1 );
+	Uint32 stamp = nextStamp();
+
+	for( int cy = y0; cy <= y1; ++cy )
+	{
+		for( int cx = x0; cx <= x1; ++cx )
+		{
+			std::unordered_map<Uint64, std::vector<int> >::iterator cell = mCells.find( getCellKey( cx, cy ) );
+			if( cell == mCells.end() )
+			{
+				continue;
+			}
+
+			std::vector<int>& ids = cell->second;
+			for( int i = 0; i < ids.size(); ++i )
+			{
+				//Boxes spanning several cells are only tested once
+				Item& item = mItems[ ids[ i ] ];
+				if( item.stamp == stamp )
+				{
+					continue;
+				}
+				item.stamp = stamp;
+
+				if( ( ignoreOwner == NULL || item.owner != ignoreOwner ) && SDL_HasIntersection( &area, &item.box ) )
+				{
+					found.push_back( ids[ i ] );
+				}
+			}
+		}
+	}
+}
+
+bool LSpatialHash::overlaps( const SDL_Rect& area, const void* ignoreOwner )
+{
+	int x0, y0, x1, y1;
+	getCellRange( area, x0, y0, x1, y1 );
+
+	for( int cy = y0; cy <= y1; ++cy )
+	{
+		for( int cx = x0; cx <= x1; ++cx )
+		{
+			std::unordered_map<Uint64, std::vector<int> >::iterator cell = mCells.find( getCellKey( cx, cy ) );
+			if( cell == mCells.end() )
+			{
+				continue;
+			}
+
+			//Finding any overlap ends the search, so repeats don't need filtering
+			std::vector<int>& ids = cell->second;
+			for( int i = 0; i < ids.size(); ++i )
+			{
+				Item& item = mItems[ ids[ i ] ];
+				if( ( ignoreOwner == NULL || item.owner != ignoreOwner ) && SDL_HasIntersection( &area, &item.box ) )
+				{
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+int LSpatialHash::getCount()
+{
+	return mCount;
+}
+
+void LSpatialHash::getCellRange( const SDL_Rect& box, int& x0, int& y0, int& x1, int& y1 )
+{
+	if( box.w <= 0 || box.h <= 0 )
+	{
+		x0 = y0 = 0;
+		x1 = y1 = -1;
+		return;
+	}
+
+	//Floor division so boxes left of or above the origin land in negative cells
+	int right = box.x + box.w - 1;
+	int bottom = box.y + box.h - 1;
+	x0 = box.x >= 0 ? box.x / mCellSize : ( box.x + 1 ) / mCellSize - 1;
+	y0 = box.y >= 0 ? box.y / mCellSize : ( box.y + 1 ) / mCellSize - 1;
+	x1 = right >= 0 ? right / mCellSize : ( right + 1 ) / mCellSize - 1;
+	y1 = bottom >= 0 ? bottom / mCellSize : ( bottom + 1 ) / mCellSize - 1;
+}
+
+Uint64 LSpatialHash::getCellKey( int cx, int cy )
+{
+	return ( (Uint64)(Uint32)cx << 32 ) | (Uint32)cy;
+}
+
+void LSpatialHash::link( int id )
+{
+	Item& item = mItems[ id ];
+	for( int cy = item.y0; cy <= item.y1; ++cy )
+	{
+		for( int cx = item.x0; cx <= item.x1; ++cx )
+		{
+			mCells[ getCellKey( cx, cy ) ].push_back( id );
+		}
+	}
+}
+
+void LSpatialHash::unlink( int id )
+{
+	Item& item = mItems[ id ];
+	for( int cy = item.y0; cy <= item.y1; ++cy )
+	{
+		for( int cx = item.x0; cx <= item.x1; ++cx )
+		{
+			//Swap the id out, cell order doesn't matter; emptied cells keep their storage for boxes moving back
+			std::vector<int>& ids = mCells[ getCellKey( cx, cy ) ];
+			for( int i = 0; i < ids.size(); ++i )
+			{
+				if( ids[ i ] == id )
+				{
+					ids[ i ] = ids.back();
+					ids.pop_back();
+					break;
+				}
+			}
+		}
+	}
+}
+
+Uint32 LSpatialHash::nextStamp()
+{
+	//On wrap around clear the old stamps so none can match by accident
+	if( ++mStamp == 0 )
+	{
+		for( int i = 0; i < mItems.size(); ++i )
+		{
+			mItems[ i ].stamp = 0;
+		}
+		mStamp = 1;
+	}
+
+	return mStamp;
+}
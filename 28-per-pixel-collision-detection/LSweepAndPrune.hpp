@@ -0,0 +1,370 @@
+//Sweep and prune broadphase
+//Each axis keeps a list of box edges sorted by position. Boxes move a little
+//between frames, so insertion sort puts the lists back in order in close to
+//linear time. Each time a left edge passes a right edge two boxes start or
+//stop overlapping on that axis, which keeps the set of overlapping pairs up
+//to date without testing every box against every other. A big batch of new
+//boxes would make insertion sort quadratic, so those are sorted in with a
+//full sort and the pairs found again with one sweep
+class LSweepAndPrune
+{
+	public:
+		//Initializes variables
+		LSweepAndPrune();
+
+		//Adds a box and returns its id, it is sorted in on the next sort
+		int insert( const SDL_Rect& box );
+
+		//Moves a box, the edge lists catch up on the next sort
+		void update( int id, const SDL_Rect& box );
+
+		//Removes a box and its pairs, its id may be handed out again
+		void remove( int id );
+
+		//Removes every box
+		void clear();
+
+		//Sorts the edge lists after boxes moved, updating the overlapping pairs
+		void sort();
+
+		//Collects the pairs of ids whose boxes overlap, as of the last sort
+		void getPairs( std::vector< std::pair<int, int> >& pairs );
+
+		//Gets the number of overlapping pairs
+		int getPairCount();
+
+		//Gets the number of edge swaps the last sort made, a measure of how much moved
+		int getSwapCount();
+
+		//Gets the number of boxes
+		int getCount();
+
+	private:
+		//A box edge, data is the box id shifted up one with the low bit set for left/top edges
+		struct Edge
+		{
+			int value;
+			Uint32 data;
+		};
+
+		//Box bounds, right and bottom are exclusive
+		struct Bounds
+		{
+			int min[ 2 ];
+			int max[ 2 ];
+			bool used;
+		};
+
+		//Sorts one axis, reporting edges that cross
+		void sortAxis( int axis );
+
+		//Sorts both axes from scratch and finds every pair with a sweep along x
+		void rebuild();
+
+		//Brings an axis' edge positions up to date
+		void refreshEdges( int axis );
+
+		//Orders edges by position, right edges first at equal positions so touching boxes don't overlap
+		static bool isBefore( const Edge& a, const Edge& b );
+
+		//Checks whether two boxes overlap on both axes
+		bool overlaps( int a, int b );
+
+		//Gets the key of a pair, the same whichever order the ids come in
+		static Uint64 getPairKey( int a, int b );
+
+		//Edge lists for x and y
+		std::vector<Edge> mEdges[ 2 ];
+
+		//Boxes by id and ids free for reuse
+		std::vector<Bounds> mBoxes;
+		std::vector<int> mFreeIds;
+		int mCount;
+
+		//Overlapping pairs
+		std::unordered_set<Uint64> mPairs;
+
+		//Swaps made by the last sort
+		int mSwapCount;
+
+		//Boxes inserted since the last sort
+		int mInserted;
+};
+
+LSweepAndPrune::LSweepAndPrune()
+{
+	//Initialize
+	mCount = 0;
+	mSwapCount = 0;
+	mInserted = 0;
+}
+
+int LSweepAndPrune::insert( const SDL_Rect& box )
+{
+	//Reuse a free id if there is one
+	int id;
+	if( !mFreeIds.empty() )
+	{
+		id = mFreeIds.back();
+		mFreeIds.pop_back();
+	}
+	else
+	{
+		id = mBoxes.size();
+		mBoxes.push_back( Bounds() );
+	}
+
+	mBoxes[ id ].used = true;
+	update( id, box );
+
+	//New edges go on the end, as if the box came in from past every other one
+	for( int axis = 0; axis < 2; ++axis )
+	{
+		Edge edge;
+		edge.value = mBoxes[ id ].max[ axis ];
+		edge.data = id << 1;
+		mEdges[ axis ].push_back( edge );
+		edge.value = mBoxes[ id ].min[ axis ];
+		edge.data = ( id << 1 ) | 1;
+		mEdges[ axis ].push_back( edge );
+	}
+
+	++mCount;
+	++mInserted;
+	return id;
+}
+
+void LSweepAndPrune::update( int id, const SDL_Rect& box )
+{
+	Bounds& bounds = mBoxes[ id ];
+
+	//Empty boxes overlap nothing, like SDL_HasIntersection, so they're parked where no edge can cross them
+	if( box.w <= 0 || box.h <= 0 )
+	{
+		bounds.min[ 0 ] = bounds.max[ 0 ] = SDL_MIN_SINT32;
+		bounds.min[ 1 ] = bounds.max[ 1 ] = SDL_MIN_SINT32;
+		return;
+	}
+
+	bounds.min[ 0 ] = box.x;
+	bounds.min[ 1 ] = box.y;
+	bounds.max[ 0 ] = box.x + box.w;
+	bounds.max[ 1 ] = box.y + box.h;
+}
+
+void LSweepAndPrune::remove( int id )
+{
+	if( id < 0 || id >= mBoxes.size() || !mBoxes[ id ].used )
+	{
+		return;
+	}
+
+	//Take the box's edges out of the lists
+	for( int axis = 0; axis < 2; ++axis )
+	{
+		std::vector<Edge>& edges = mEdges[ axis ];
+		int kept = 0;
+		for( int i = 0; i < edges.size(); ++i )
+		{
+			if( ( edges[ i ].data >> 1 ) != id )
+			{
+				edges[ kept++ ] = edges[ i ];
+			}
+		}
+		edges.resize( kept );
+	}
+
+	//And any pairs it was in
+	for( std::unordered_set<Uint64>::iterator pair = mPairs.begin(); pair != mPairs.end(); )
+	{
+		if( ( *pair >> 32 ) == id || ( *pair & 0xFFFFFFFF ) == id )
+		{
+			pair = mPairs.erase( pair );
+		}
+		else
+		{
+			++pair;
+		}
+	}
+
+	mBoxes[ id ].used = false;
+	mFreeIds.push_back( id );
+	--mCount;
+}
+
+void LSweepAndPrune::clear()
+{
+	mEdges[ 0 ].clear();
+	mEdges[ 1 ].clear();
+	mBoxes.clear();
+	mFreeIds.clear();
+	mPairs.clear();
+	mCount = 0;
+	mSwapCount = 0;
+	mInserted = 0;
+}
+
+void LSweepAndPrune::sort()
+{
+	mSwapCount = 0;
+
+	//Each new box's edges sort in from the end, past about half the list
+	if( mInserted > 32 )
+	{
+		rebuild();
+	}
+	else
+	{
+		sortAxis( 0 );
+		sortAxis( 1 );
+	}
+
+	mInserted = 0;
+}
+
+void LSweepAndPrune::getPairs( std::vector< std::pair<int, int> >& pairs )
+{
+	pairs.clear();
+	pairs.reserve( mPairs.size() );
+	for( std::unordered_set<Uint64>::iterator pair = mPairs.begin(); pair != mPairs.end(); ++pair )
+	{
+		pairs.push_back( std::make_pair( (int)( *pair >> 32 ), (int)( *pair & 0xFFFFFFFF ) ) );
+	}
+}
+
+int LSweepAndPrune::getPairCount()
+{
+	return mPairs.size();
+}
+
+int LSweepAndPrune::getSwapCount()
+{
+	return mSwapCount;
+}
+
+int LSweepAndPrune::getCount()
+{
+	return mCount;
+}
+
+void LSweepAndPrune::sortAxis( int axis )
+{
+	std::vector<Edge>& edges = mEdges[ axis ];
+	refreshEdges( axis );
+
+	//Insertion sort, cheap when boxes only moved a little
+	for( int i = 1; i < edges.size(); ++i )
+	{
+		Edge edge = edges[ i ];
+		int j = i;
+		while( j > 0 && isBefore( edge, edges[ j - 1 ] ) )
+		{
+			const Edge& other = edges[ j - 1 ];
+			int id = edge.data >> 1;
+			int otherId = other.data >> 1;
+			if( id != otherId )
+			{
+				if( ( edge.data & 1 ) && !( other.data & 1 ) )
+				{
+					//A left edge moved past a right edge, the boxes now overlap on this axis
+					if( overlaps( id, otherId ) )
+					{
+						mPairs.insert( getPairKey( id, otherId ) );
+					}
+				}
+				else if( !( edge.data & 1 ) && ( other.data & 1 ) )
+				{
+					//A right edge moved past a left edge, the boxes came apart
+					mPairs.erase( getPairKey( id, otherId ) );
+				}
+			}
+
+			edges[ j ] = other;
+			--j;
+			++mSwapCount;
+		}
+		edges[ j ] = edge;
+	}
+}
+
+void LSweepAndPrune::rebuild()
+{
+	for( int axis = 0; axis < 2; ++axis )
+	{
+		refreshEdges( axis );
+		std::sort( mEdges[ axis ].begin(), mEdges[ axis ].end(), isBefore );
+	}
+
+	//Sweep along x keeping the boxes whose left edge was passed but not their right one
+	mPairs.clear();
+	std::vector<int> active;
+	std::vector<int> activeIndex( mBoxes.size() );
+	std::vector<Edge>& edges = mEdges[ 0 ];
+	for( int i = 0; i < edges.size(); ++i )
+	{
+		//Empty boxes overlap nothing, and their right edge sorts before their left one
+		int id = edges[ i ].data >> 1;
+		if( mBoxes[ id ].min[ 0 ] == mBoxes[ id ].max[ 0 ] )
+		{
+			continue;
+		}
+
+		if( edges[ i ].data & 1 )
+		{
+			//Every active box overlaps this one on x
+			for( int n = 0; n < active.size(); ++n )
+			{
+				if( overlaps( id, active[ n ] ) )
+				{
+					mPairs.insert( getPairKey( id, active[ n ] ) );
+				}
+			}
+
+			activeIndex[ id ] = active.size();
+			active.push_back( id );
+		}
+		else
+		{
+			//Swap the box out of the active list
+			int last = active.back();
+			active[ activeIndex[ id ] ] = last;
+			activeIndex[ last ] = activeIndex[ id ];
+			active.pop_back();
+		}
+	}
+}
+
+void LSweepAndPrune::refreshEdges( int axis )
+{
+	std::vector<Edge>& edges = mEdges[ axis ];
+	for( int i = 0; i < edges.size(); ++i )
+	{
+		const Bounds& bounds = mBoxes[ edges[ i ].data >> 1 ];
+		edges[ i ].value = ( edges[ i ].data & 1 ) ? bounds.min[ axis ] : bounds.max[ axis ];
+	}
+}
+
+bool LSweepAndPrune::isBefore( const Edge& a, const Edge& b )
+{
+	return a.value < b.value || ( a.value == b.value && ( a.data & 1 ) < ( b.data & 1 ) );
+}
+
+bool LSweepAndPrune::overlaps( int a, int b )
+{
+	const Bounds& boxA = mBoxes[ a ];
+	const Bounds& boxB = mBoxes[ b ];
+
+	return boxA.min[ 0 ] < boxB.max[ 0 ] && boxB.min[ 0 ] < boxA.max[ 0 ] &&
+		boxA.min[ 1 ] < boxB.max[ 1 ] && boxB.min[ 1 ] < boxA.max[ 1 ];
+}
+
+Uint64 LSweepAndPrune::getPairKey( int a, int b )
+{
+	if( a > b )
+	{
+		int swap = a;
+		a = b;
+		b = swap;
+	}
+	return ( (Uint64)a << 32 ) | (Uint32)b;
+}
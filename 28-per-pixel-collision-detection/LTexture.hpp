@@ -11,6 +11,9 @@ class LTexture
 		//Loads image at specified path
 		bool loadFromFile( SDL_Renderer* renderer, std::string path );
 
+		//Shares the cached texture for the specified path
+		bool loadFromCache( LTextureCache& cache, SDL_Renderer* renderer, std::string path );
+
 		//Deallocates texture
 		void free();
 
@@ -35,6 +38,13 @@ class LTexture
 		SDL_Texture* mTexture;
 		SDL_Renderer* mRenderer;
 
+		//Keeps a cached texture alive, empty when the texture is owned
+		LTextureHandle mShared;
+
+		//Modulation and blending, set again before rendering a shared texture other holders may have changed
+		SDL_Color mColor;
+		SDL_BlendMode mBlendMode;
+
 		//Image dimensions
 		int mWidth;
 		int mHeight;
@@ -47,6 +57,8 @@ LTexture::LTexture()
 	mRenderer = NULL;
 	mWidth = 0;
 	mHeight = 0;
+	mColor.r = mColor.g = mColor.b = mColor.a = 0xFF;
+	mBlendMode = SDL_BLENDMODE_NONE;
 }
 
 LTexture::~LTexture()
@@ -99,12 +111,39 @@ bool LTexture::loadFromFile( SDL_Renderer* renderer, std::string path )
 	return mTexture != NULL;
 }
 
+bool LTexture::loadFromCache( LTextureCache& cache, SDL_Renderer* renderer, std::string path )
+{
+	//Get rid of preexisting texture
+	free();
+
+	//Share the cached texture
+	mShared = cache.load( renderer, path );
+	if( mShared )
+	{
+		mRenderer = renderer;
+		mTexture = mShared->texture;
+		mWidth = mShared->width;
+		mHeight = mShared->height;
+
+		//This handle starts unmodulated whatever other holders did
+		mColor.r = mColor.g = mColor.b = mColor.a = 0xFF;
+		mBlendMode = mShared->blendMode;
+	}
+
+	//Return success
+	return mTexture != NULL;
+}
+
 void LTexture::free()
 {
 	//Free texture if it exists
 	if( mTexture != NULL )
 	{
-		SDL_DestroyTexture( mTexture );
+		//Release shared textures to the cache instead of destroying them
+		if( mShared )
+			mShared.reset();
+		else
+			SDL_DestroyTexture( mTexture );
 		mTexture = NULL;
 		mRenderer = NULL;
 		mWidth = 0;
@@ -115,18 +154,23 @@ void LTexture::free()
 void LTexture::setColor( Uint8 red, Uint8 green, Uint8 blue )
 {
 	//Modulate texture
+	mColor.r = red;
+	mColor.g = green;
+	mColor.b = blue;
 	SDL_SetTextureColorMod( mTexture, red, green, blue );
 }
 
 void LTexture::setBlendMode( SDL_BlendMode blending )
 {
 	//Set blending function
+	mBlendMode = blending;
 	SDL_SetTextureBlendMode( mTexture, blending );
 }
 
 void LTexture::setAlpha( Uint8 alpha )
 {
 	//Modulate texture alpha
+	mColor.a = alpha;
 	SDL_SetTextureAlphaMod( mTexture, alpha );
 }
 
@@ -142,6 +186,14 @@ void LTexture::render( int x, int y, SDL_Rect* clip, double angle, SDL_Point* ce
 		renderQuad.h = clip->h;
 	}
 
+	//Other holders of a shared texture may have modulated it since
+	if( mShared )
+	{
+		SDL_SetTextureColorMod( mTexture, mColor.r, mColor.g, mColor.b );
+		SDL_SetTextureAlphaMod( mTexture, mColor.a );
+		SDL_SetTextureBlendMode( mTexture, mBlendMode );
+	}
+
 	//Render to screen
 	SDL_RenderCopyEx( mRenderer, mTexture, clip, &renderQuad, angle, center, flip );
 }
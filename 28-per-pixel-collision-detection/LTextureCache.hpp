@@ -0,0 +1,188 @@
+//A texture shared through the texture cache
+struct LCachedTexture
+{
+	//The hardware texture and its dimensions
+	SDL_Texture* texture;
+	int width;
+	int height;
+
+	//Blend mode it was created with, each handle starts from it
+	SDL_BlendMode blendMode;
+
+	//Destroys the texture once the last handle is gone
+	~LCachedTexture();
+};
+
+//Handle keeping a cached texture alive
+typedef std::shared_ptr<LCachedTexture> LTextureHandle;
+
+//Reference counted texture cache keyed by renderer and canonical path
+//Textures nobody holds a handle to stay cached until the byte budget forces
+//the least recently used of them out. Every holder shares one SDL_Texture,
+//so its color, alpha and blend mode are whatever the last holder set;
+//LTexture keeps its own and sets them again before each render
+class LTextureCache
+{
+	public:
+		//Initializes variables
+		LTextureCache( size_t budgetBytes = 64 * 1024 * 1024 );
+
+		//Deallocates memory
+		~LTextureCache();
+
+		//Gets a handle to the texture for path, loading it on the first request
+		LTextureHandle load( SDL_Renderer* renderer, std::string path );
+
+		//Sets the byte budget and evicts down to it
+		void setBudget( size_t budgetBytes );
+
+		//Evicts unused textures, least recently used first, until under budget
+		void trim();
+
+		//Drops every cached texture, handles still held stay valid
+		void clear();
+
+		//Gets the estimated texture memory held by the cache
+		size_t getBytes();
+
+	private:
+		//A texture only works with the renderer that created it
+		typedef std::pair<SDL_Renderer*, std::string> Key;
+
+		//A cached texture and its place in the recency list
+		struct Entry
+		{
+			LTextureHandle texture;
+			size_t bytes;
+			std::list<Key>::iterator recent;
+		};
+
+		//Cached textures by renderer and canonical path
+		std::map<Key, Entry> mEntries;
+
+		//Keys from most to least recently used
+		std::list<Key> mRecent;
+
+		//Memory budget and usage
+		size_t mBudget;
+		size_t mBytes;
+};
+
+LCachedTexture::~LCachedTexture()
+{
+	if( texture != NULL )
+	{
+		SDL_DestroyTexture( texture );
+	}
+}
+
+LTextureCache::LTextureCache( size_t budgetBytes )
+{
+	//Initialize
+	mBudget = budgetBytes;
+	mBytes = 0;
+}
+
+LTextureCache::~LTextureCache()
+{
+	//Deallocate
+	clear();
+}
+
+LTextureHandle LTextureCache::load( SDL_Renderer* renderer, std::string path )
+{
+	//Resolve the path so different spellings of one file share an entry
+	Key key( renderer, path );
+	char* resolved = realpath( path.c_str(), NULL );
+	if( resolved != NULL )
+	{
+		key.second = resolved;
+		::free( resolved );
+	}
+
+	//Return the cached texture and mark it as most recently used
+	std::map<Key, Entry>::iterator it = mEntries.find( key );
+	if( it != mEntries.end() )
+	{
+		mRecent.splice( mRecent.begin(), mRecent, it->second.recent );
+		return it->second.texture;
+	}
+
+	//Load image at specified path
+	SDL_Surface* loadedSurface = IMG_Load( path.c_str() );
+	if( loadedSurface == NULL )
+	{
+		printf( "Unable to load image %s! SDL_image Error: %s\n", path.c_str(), IMG_GetError() );
+		return LTextureHandle();
+	}
+
+	//Color key image
+	SDL_SetColorKey( loadedSurface, SDL_TRUE, SDL_MapRGB( loadedSurface->format, 0, 0xFF, 0xFF ) );
+
+	//Create texture from surface pixels
+	LTextureHandle handle;
+	SDL_Texture* newTexture = SDL_CreateTextureFromSurface( renderer, loadedSurface );
+	if( newTexture == NULL )
+	{
+		printf( "unable to create texture from %s! SDL Error: %s\n", path.c_str(), SDL_GetError() );
+	}
+	else
+	{
+		handle.reset( new LCachedTexture() );
+		handle->texture = newTexture;
+		handle->width = loadedSurface->w;
+		handle->height = loadedSurface->h;
+		SDL_GetTextureBlendMode( newTexture, &handle->blendMode );
+
+		//Remember it, estimating four bytes per pixel
+		mRecent.push_front( key );
+		Entry& entry = mEntries[ key ];
+		entry.texture = handle;
+		entry.bytes = (size_t)handle->width * handle->height * 4;
+		entry.recent = mRecent.begin();
+		mBytes += entry.bytes;
+	}
+
+	//Get rid of old loaded surface
+	SDL_FreeSurface( loadedSurface );
+
+	//Make room for the new texture
+	trim();
+
+	return handle;
+}
+
+void LTextureCache::setBudget( size_t budgetBytes )
+{
+	mBudget = budgetBytes;
+	trim();
+}
+
+void LTextureCache::trim()
+{
+	//Walk from the least recently used end, skipping textures still in use
+	std::list<Key>::iterator it = mRecent.end();
+	while( mBytes > mBudget && it != mRecent.begin() )
+	{
+		--it;
+		Entry& entry = mEntries[ *it ];
+		if( entry.texture.use_count() == 1 )
+		{
+			mBytes -= entry.bytes;
+			mEntries.erase( *it );
+			it = mRecent.erase( it );
+		}
+	}
+}
+
+void LTextureCache::clear()
+{
+	mEntries.clear();
+	mRecent.clear();
+	mBytes = 0;
+}
+
+size_t LTextureCache::getBytes()
+{
+	return mBytes;
+}
@@ -1,32 +1,59 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <map>
+#include <memory>
+#include "LTextureCache.hpp"
 #include "LTexture.hpp"
+#include "LFrameSnapshot.hpp"
+#include "LRenderThread.hpp"
+#include "LFramePacer.hpp"
+#include "LSpatialHash.hpp"
+#include "LCollisionMask.hpp"
 #include "Dot.hpp"
 
 //Screen dimension constants
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
 
+//Simulation rate, the dot moves a pixel per update
+const int SCREEN_FPS = 60;
+
 //Starts up SDL and creates window
 bool init();
 
 //Loads media
 bool loadMedia();
 
+//Loads textures, called on the render thread
+bool loadTextures( SDL_Renderer* renderer );
+
+//Frees textures, called on the render thread
+void freeTextures();
+
 //Frees media and shuts down SDL
 void close();
 
 //The window we'll be rendering to
 SDL_Window* gWindow = NULL;
 
-//The window renderer
-SDL_Renderer* gRenderer = NULL;
+//Owns the window renderer and draws the frames the main loop publishes
+LRenderThread gRenderThread;
+
+//Shared textures
+LTextureCache gTextureCache;
 
 //Textures
 LTexture gDotTexture;
 
+//Solid pixels of the dot
+LCollisionMask gDotMask;
+
 bool init()
 {
 	//Initialization flag
@@ -55,24 +82,12 @@ bool init()
 		}
 		else
 		{
-			//Create renderer for window
-			gRenderer = SDL_CreateRenderer( gWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC ); 
-			if( gRenderer == NULL ) {
-				printf( "Renderer could not be created! SDL Error: %s\n", SDL_GetError() );
-				success = false;
-			}
-			else
+			//Initialize PNG loading
+			int imgFlags = IMG_INIT_PNG;
+			if( !( IMG_Init( imgFlags ) & imgFlags ) )
 			{
-				//Initialize renderer color
-				SDL_SetRenderDrawColor( gRenderer, 0xFF, 0xFF, 0xFF, 0xFF );
-
-				//Initialize PNG loading
-				int imgFlags = IMG_INIT_PNG;
-				if( !( IMG_Init( imgFlags ) & imgFlags ) )
-				{
-					printf( "SDL_image could not initialize! SDL_image Error: %s\n", IMG_GetError() );
-					success = false;
-				}
+				printf( "SDL_image could not initialize! SDL_image Error: %s\n", IMG_GetError() );
+				success = false;
 			}
 		}
 	}
@@ -85,8 +100,30 @@ bool loadMedia()
 	//Loading success flag
 	bool success = true;
 
+	//Create the renderer and its textures on the render thread, vsync stalls stay there
+	if( !gRenderThread.start( gWindow, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC, loadTextures, freeTextures ) )
+	{
+		printf( "Render thread could not be started!\n" );
+		success = false;
+	}
+
+	//Load the dot's collision mask
+	if( !gDotMask.loadFromFile( "textures/dot.bmp" ) )
+	{
+		printf( "Failed to load collision mask!\n" );
+		success = false;
+	}
+
+	return success;
+}
+
+bool loadTextures( SDL_Renderer* renderer )
+{
+	//Loading success flag
+	bool success = true;
+
 	//Load front alpha texture
-	if( !gDotTexture.loadFromFile( gRenderer, "textures/dot.bmp" ) )
+	if( !gDotTexture.loadFromCache( gTextureCache, renderer, "textures/dot.bmp" ) )
 	{
 		printf( "Failed to load texture image!\n" );
 		success = false;
@@ -95,16 +132,22 @@ bool loadMedia()
 	return success;
 }
 
-void close()
+void freeTextures()
 {
 	//Free loaded images
 	gDotTexture.free();
+	gTextureCache.clear();
+}
+
+void close()
+{
+	//Free textures and the renderer on their thread
+	gRenderThread.stop();
+	gDotMask.free();
 
 	//Destroy window	
-	SDL_DestroyRenderer( gRenderer );
 	SDL_DestroyWindow( gWindow );
 	gWindow = NULL;
-	gRenderer = NULL;
 
 	//Quit SDL subsystems
 	IMG_Quit();
@@ -137,12 +180,43 @@ int main( int argc, char* args[] )
 			//The dot that will be moving around on the screen
 			Dot dot = Dot(SCREEN_WIDTH, SCREEN_HEIGHT);
 
+			/* the dot that will be collided against */
+			Dot otherDot = Dot(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_WIDTH / 4, SCREEN_HEIGHT / 4);
+
+			/* both dots collide by their pixels */
+			dot.setMask(&gDotMask);
+			otherDot.setMask(&gDotMask);
+
 			/* set the wall */
+			std::vector<SDL_Rect> walls;
 			SDL_Rect wall;
 			wall.x = 300;
 			wall.y = 40;
 			wall.w = 40;
 			wall.h = 400;
+			walls.push_back(wall);
+
+			/* scatter extra small walls given on the command line, clear of the dot's start */
+			int extraWalls = argc > 1 ? atoi(args[1]) : 0;
+			SDL_Rect start = { 0, 0, Dot::DOT_WIDTH * 2, Dot::DOT_HEIGHT * 2 };
+			while (extraWalls > 0) {
+				SDL_Rect box = { rand() % (SCREEN_WIDTH - 8), rand() % (SCREEN_HEIGHT - 8), 2 + rand() % 6, 2 + rand() % 6 };
+				if (SDL_HasIntersection(&box, &start) || SDL_HasIntersection(&box, &otherDot.getCollider()))
+					continue;
+				walls.push_back(box);
+				--extraWalls;
+			}
+
+			/* index the walls and the dot for collision queries */
+			LSpatialHash world(32);
+			for (int i = 0; i < walls.size(); ++i)
+				world.insert(walls[i]);
+			dot.attach(world);
+			otherDot.attach(world);
+
+			/* presenting no longer paces the loop, so it keeps its own time */
+			LFramePacer pacer( SCREEN_FPS );
+			pacer.start();
 
 			//While application is running
 			while( !quit )
@@ -161,21 +235,23 @@ int main( int argc, char* args[] )
 				}
 
 				/* move the dot */
-				dot.move(wall);
+				dot.move(world);
 
-				//Clear screen
-				SDL_SetRenderDrawColor( gRenderer, 0xFF, 0xFF, 0xFF, 0xFF );
-				SDL_RenderClear( gRenderer );
+				/* copy what to draw into the snapshot, cleared to white */
+				LFrameSnapshot& frame = gRenderThread.getSnapshot();
 
-				/* render wall */
-				SDL_SetRenderDrawColor( gRenderer, 0x00, 0x00, 0x00, 0xFF );
-				SDL_RenderDrawRect(gRenderer, &wall);
+				/* render walls */
+				frame.setColor(0x00, 0x00, 0x00);
+				frame.addRects(&walls[0], walls.size());
 
-				/* render dot */
-				dot.render(&gDotTexture);
+				/* render dots */
+				frame.setColor(0xFF, 0xFF, 0xFF);
+				dot.render(frame, &gDotTexture);
+				otherDot.render(frame, &gDotTexture);
 
-				//Update screen
-				SDL_RenderPresent( gRenderer );
+				//Hand the frame to the render thread and wait for the next update
+				gRenderThread.publish();
+				pacer.wait();
 			}
 		}
 	}
@@ -0,0 +1,428 @@
+//Stress scene: many dots drifting over a large field, their collisions found
+//with sweep and prune and checked pixel by pixel. Motion, the pixel tests and
+//finding what to draw are spread over every core with the job system
+//usage: swarm [dots] [threads]         shows the top left of the field, colliding dots in red
+//       swarm scale [dots] [threads]   times sweep and prune against testing every pair, headless
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <map>
+#include <memory>
+#include <algorithm>
+#include "LTextureCache.hpp"
+#include "LTexture.hpp"
+#include "LCollisionMask.hpp"
+#include "LSweepAndPrune.hpp"
+#include "LEntityStore.hpp"
+#include "LJobSystem.hpp"
+
+//Screen dimension constants
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+
+//Field area per dot, in dot areas; keeps the crowding the same at any count
+const int AREA_PER_DOT = 16;
+
+//Largest count the every pair test is timed at, it is quadratic
+const int MAX_BRUTE_DOTS = 16000;
+
+//Items per job; enough that queuing a job costs little next to running it
+const int DOT_GRAIN = 16384;
+const int PAIR_GRAIN = 1024;
+
+//The window we'll be rendering to
+SDL_Window* gWindow = NULL;
+
+//The window renderer
+SDL_Renderer* gRenderer = NULL;
+
+//Shared textures
+LTextureCache gTextureCache;
+
+//Textures
+LTexture gDotTexture;
+
+//Solid pixels of the dot
+LCollisionMask gDotMask;
+
+//Spreads the systems over the cores
+LJobSystem gJobs;
+
+//A field of dots and the broadphase tracking them
+struct Swarm
+{
+	LEntityStore dots;
+	LSweepAndPrune broadphase;
+	std::vector< std::pair<int, int> > pairs;
+	std::vector<Uint8> touching;
+	std::vector<Uint8> colliding;
+	int side;
+	int hits;
+
+	//Dots in view, one list per thread so they can be found in parallel
+	SDL_Rect view;
+	std::vector< std::vector<int> > visible;
+};
+
+//Gets elapsed milliseconds between two performance counter readings
+double elapsedMs( Uint64 start, Uint64 end )
+{
+	return (double)( end - start ) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+//Job bodies, data is the swarm
+void moveJob( void* data, int begin, int end )
+{
+	Swarm* swarm = (Swarm*)data;
+	swarm->dots.move( swarm->side, swarm->side, begin, end );
+}
+
+void pairJob( void* data, int begin, int end )
+{
+	Swarm* swarm = (Swarm*)data;
+	swarm->dots.testPairs( swarm->pairs, begin, end, gDotMask, &swarm->touching[ 0 ] );
+}
+
+void visibleJob( void* data, int begin, int end )
+{
+	Swarm* swarm = (Swarm*)data;
+	swarm->dots.findVisible( swarm->view, begin, end, swarm->visible[ LJobSystem::getThreadIndex() ] );
+}
+
+//Scatters count dots with random velocities over a square field
+void spawn( Swarm& swarm, int count )
+{
+	//Dots are the size of their mask
+	int width = gDotMask.getWidth();
+	int height = gDotMask.getHeight();
+	int side = (int)sqrt( (double)count * width * height * AREA_PER_DOT );
+	swarm.side = SDL_max( side, SDL_max( SCREEN_WIDTH, SCREEN_HEIGHT ) );
+
+	swarm.dots.clear();
+	swarm.broadphase.clear();
+	swarm.dots.reserve( count );
+	for( int i = 0; i < count; ++i )
+	{
+		int velX = 0, velY = 0;
+		while( velX == 0 && velY == 0 )
+		{
+			velX = rand() % 7 - 3;
+			velY = rand() % 7 - 3;
+		}
+
+		swarm.dots.create( rand() % ( swarm.side - width ), rand() % ( swarm.side - height ), width, height, velX, velY );
+	}
+
+	swarm.colliding.assign( count, 0 );
+	swarm.hits = 0;
+}
+
+//Moves every dot and finds the ones touching, returns the time the motion system took
+double step( Swarm& swarm )
+{
+	Uint64 start = SDL_GetPerformanceCounter();
+	gJobs.parallelFor( moveJob, &swarm, swarm.dots.getCount(), DOT_GRAIN );
+	double moveMs = elapsedMs( start, SDL_GetPerformanceCounter() );
+
+	//The broadphase depends on the order of its edge lists, so it runs on one thread
+	swarm.dots.updateBroadphase( swarm.broadphase );
+	swarm.broadphase.sort();
+	swarm.broadphase.getPairs( swarm.pairs );
+
+	//Broadphase pairs go on to the pixel test
+	swarm.touching.resize( swarm.pairs.size() );
+	gJobs.parallelFor( pairJob, &swarm, swarm.pairs.size(), PAIR_GRAIN );
+	swarm.hits = swarm.dots.flagColliding( swarm.pairs, swarm.touching.empty() ? NULL : &swarm.touching[ 0 ], swarm.colliding );
+
+	return moveMs;
+}
+
+//Tests every pair of dots, returning the number of overlapping boxes and counting pixel hits
+int stepEveryPair( Swarm& swarm, int& hits )
+{
+	int boxes = 0;
+	hits = 0;
+	for( int a = 0; a < swarm.dots.getCount(); ++a )
+	{
+		SDL_Rect boxA = swarm.dots.getCollider( a );
+		for( int b = a + 1; b < swarm.dots.getCount(); ++b )
+		{
+			SDL_Rect boxB = swarm.dots.getCollider( b );
+			if( SDL_HasIntersection( &boxA, &boxB ) )
+			{
+				++boxes;
+				hits += gDotMask.collides( boxA.x, boxA.y, gDotMask, boxB.x, boxB.y );
+			}
+		}
+	}
+	return boxes;
+}
+
+//Times both approaches at doubling dot counts
+int runScale( int maxDots )
+{
+	printf( "%d threads\n", gJobs.getThreadCount() );
+	printf( "%8s %10s %12s %10s %10s %8s %14s\n", "dots", "move ms", "step ms", "swaps", "pairs", "hits", "every pair ms" );
+
+	bool success = true;
+	for( int count = 1000; ; count *= 2 )
+	{
+		//Finish on the count asked for
+		count = SDL_min( count, maxDots );
+
+		Swarm swarm;
+		spawn( swarm, count );
+
+		//The first step sorts everything in, time the coherent steps after it
+		step( swarm );
+		const int frames = 60;
+		double swaps = 0;
+		double moveMs = 0;
+		Uint64 start = SDL_GetPerformanceCounter();
+		for( int i = 0; i < frames; ++i )
+		{
+			moveMs += step( swarm );
+			swaps += swarm.broadphase.getSwapCount();
+		}
+		double stepMs = elapsedMs( start, SDL_GetPerformanceCounter() ) / frames;
+
+		printf( "%8d %10.3f %12.3f %10.0f %10d %8d ", count, moveMs / frames, stepMs, swaps / frames, (int)swarm.pairs.size(), swarm.hits );
+
+		//The same frame tested pair by pair, which has to agree
+		if( count <= MAX_BRUTE_DOTS )
+		{
+			int hits;
+			start = SDL_GetPerformanceCounter();
+			int boxes = stepEveryPair( swarm, hits );
+			printf( "%14.3f\n", elapsedMs( start, SDL_GetPerformanceCounter() ) );
+
+			if( boxes != swarm.pairs.size() || hits != swarm.hits )
+			{
+				printf( "Every pair test found %d pairs and %d hits!\n", boxes, hits );
+				success = false;
+			}
+		}
+		else
+		{
+			printf( "%14s\n", "-" );
+		}
+
+		if( count == maxDots )
+		{
+			break;
+		}
+	}
+
+	return success ? 0 : 1;
+}
+
+bool init()
+{
+	//Initialization flag
+	bool success = true;
+
+	//Initialize SDL
+	if( SDL_Init( SDL_INIT_VIDEO ) < 0 )
+	{
+		printf( "SDL could not initialize! SDL Error: %s\n", SDL_GetError() );
+		success = false;
+	}
+	else
+	{
+		//Create window
+		gWindow = SDL_CreateWindow( "SDL Tutorial", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN );
+		if( gWindow == NULL )
+		{
+			printf( "Window could not be created! SDL Error: %s\n", SDL_GetError() );
+			success = false;
+		}
+		else
+		{
+			//Create renderer for window
+			gRenderer = SDL_CreateRenderer( gWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC );
+			if( gRenderer == NULL )
+			{
+				printf( "Renderer could not be created! SDL Error: %s\n", SDL_GetError() );
+				success = false;
+			}
+			else
+			{
+				//Initialize renderer color
+				SDL_SetRenderDrawColor( gRenderer, 0xFF, 0xFF, 0xFF, 0xFF );
+			}
+		}
+	}
+
+	return success;
+}
+
+bool loadMedia()
+{
+	//Loading success flag
+	bool success = true;
+
+	//Load the dot's texture, there's no renderer when running headless
+	if( gRenderer != NULL && !gDotTexture.loadFromCache( gTextureCache, gRenderer, "textures/dot.bmp" ) )
+	{
+		printf( "Failed to load texture image!\n" );
+		success = false;
+	}
+
+	//Load the dot's collision mask
+	if( !gDotMask.loadFromFile( "textures/dot.bmp" ) )
+	{
+		printf( "Failed to load collision mask!\n" );
+		success = false;
+	}
+
+	return success;
+}
+
+void close()
+{
+	//Free loaded images
+	gDotTexture.free();
+	gDotMask.free();
+	gTextureCache.clear();
+
+	//Destroy window
+	SDL_DestroyRenderer( gRenderer );
+	SDL_DestroyWindow( gWindow );
+	gWindow = NULL;
+	gRenderer = NULL;
+
+	//Quit SDL subsystems
+	IMG_Quit();
+	SDL_Quit();
+}
+
+int main( int argc, char* args[] )
+{
+	//Headless timing run
+	if( argc > 1 && strcmp( args[ 1 ], "scale" ) == 0 )
+	{
+		int maxDots = argc > 2 ? atoi( args[ 2 ] ) : 128000;
+		int threads = argc > 3 ? atoi( args[ 3 ] ) : 0;
+		if( maxDots < 1000 || SDL_Init( 0 ) < 0 || !loadMedia() || !gJobs.start( threads - 1 ) )
+		{
+			printf( "usage: %s scale [dots] [threads], at least 1000 dots\n", args[ 0 ] );
+			return 1;
+		}
+
+		int result = runScale( maxDots );
+		gJobs.stop();
+		close();
+		return result;
+	}
+
+	int count = argc > 1 ? atoi( args[ 1 ] ) : 100000;
+	int threads = argc > 2 ? atoi( args[ 2 ] ) : 0;
+	if( count <= 0 )
+	{
+		printf( "usage: %s [dots] [threads]\n", args[ 0 ] );
+		return 1;
+	}
+
+	//Start up SDL and create window
+	if( !init() )
+	{
+		printf( "Failed to initialize!\n" );
+	}
+	else if( !loadMedia() )
+	{
+		printf( "Failed to load media!\n" );
+	}
+	else if( !gJobs.start( threads - 1 ) )
+	{
+		printf( "Failed to start job workers!\n" );
+	}
+	else
+	{
+		Swarm swarm;
+		spawn( swarm, count );
+		swarm.visible.resize( gJobs.getThreadCount() );
+
+		//Main loop flag
+		bool quit = false;
+
+		//Event handler
+		SDL_Event e;
+
+		//Frame time for the title
+		Uint64 lastTitle = SDL_GetPerformanceCounter();
+		double stepMs = 0;
+		int frames = 0;
+
+		//While application is running
+		while( !quit )
+		{
+			//Handle events on queue
+			while( SDL_PollEvent( &e ) != 0 )
+			{
+				//User requests quit
+				if( e.type == SDL_QUIT )
+				{
+					quit = true;
+				}
+			}
+
+			Uint64 start = SDL_GetPerformanceCounter();
+			step( swarm );
+			stepMs += elapsedMs( start, SDL_GetPerformanceCounter() );
+			++frames;
+
+			//Clear screen
+			SDL_SetRenderDrawColor( gRenderer, 0xFF, 0xFF, 0xFF, 0xFF );
+			SDL_RenderClear( gRenderer );
+
+			//Find the dots in view on every core
+			SDL_Rect view = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+			swarm.view = view;
+			for( int i = 0; i < swarm.visible.size(); ++i )
+			{
+				swarm.visible[ i ].clear();
+			}
+			gJobs.parallelFor( visibleJob, &swarm, swarm.dots.getCount(), DOT_GRAIN );
+
+			//Render them, colliding ones tinted
+			for( int list = 0; list < swarm.visible.size(); ++list )
+			{
+				for( int i = 0; i < swarm.visible[ list ].size(); ++i )
+				{
+					int dot = swarm.visible[ list ][ i ];
+					SDL_Rect box = swarm.dots.getCollider( dot );
+					gDotTexture.setColor( 0xFF, swarm.colliding[ dot ] ? 0x40 : 0xFF, swarm.colliding[ dot ] ? 0x40 : 0xFF );
+					gDotTexture.render( box.x, box.y );
+				}
+			}
+
+			//Update screen
+			SDL_RenderPresent( gRenderer );
+
+			//Show the step cost about once a second
+			if( elapsedMs( lastTitle, SDL_GetPerformanceCounter() ) >= 1000.0 )
+			{
+				char title[ 128 ];
+				snprintf( title, sizeof( title ), "%d dots, %.2f ms/step, %d pairs, %d hits", count, stepMs / frames, (int)swarm.pairs.size(), swarm.hits );
+				SDL_SetWindowTitle( gWindow, title );
+				lastTitle = SDL_GetPerformanceCounter();
+				stepMs = 0;
+				frames = 0;
+			}
+		}
+	}
+
+	//Free resources and close SDL
+	gJobs.stop();
+	close();
+
+	return 0;
+}
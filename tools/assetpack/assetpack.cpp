@@ -0,0 +1,175 @@
+/*
+ * assetpack - bundles asset directories into one pack file
+ *
+ * usage: assetpack <pack file> <directory>...
+ *
+ * Every file under the directories is stored under its path relative to the
+ * current directory, so "tex/prompt.png" in the pack is read by the same
+ * name LAssetPack is asked for. The pack is little endian:
+ *
+ *   Uint32 magic ("LPAK"), Uint32 version, Uint32 entry count, Uint32 TOC size
+ *   per entry: Uint64 offset, Uint64 size, Uint16 name length, name bytes
+ *   blobs, each starting on a PACK_ALIGNMENT boundary
+ */
+#include <SDL2/SDL.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+/* pack file identification */
+const Uint32 PACK_MAGIC = 0x4B41504C;
+const Uint32 PACK_VERSION = 1;
+
+/* blob alignment, enough for any type the loaders read in place */
+const Uint64 PACK_ALIGNMENT = 16;
+
+/* size of the fixed header */
+const Uint64 PACK_HEADER_SIZE = 16;
+
+/* a file going into the pack */
+struct Entry
+{
+	std::string name;
+	Uint64 offset;
+	Uint64 size;
+};
+
+/* rounds up to the blob alignment */
+Uint64 align(Uint64 offset)
+{
+	return (offset + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT;
+}
+
+/* collects every regular file below path */
+bool collect(std::string path, std::vector<Entry>& entries)
+{
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0) {
+		printf("Unable to find %s!\n", path.c_str());
+		return false;
+	}
+
+	if (S_ISREG(info.st_mode)) {
+		if (path.size() > 0xFFFF) {
+			printf("Path %s is too long!\n", path.c_str());
+			return false;
+		}
+
+		Entry entry = { path, 0, (Uint64)info.st_size };
+		entries.push_back(entry);
+		return true;
+	}
+
+	DIR* d = opendir(path.c_str());
+	if (d == NULL) {
+		printf("Unable to open directory %s!\n", path.c_str());
+		return false;
+	}
+
+	bool success = true;
+	struct dirent* child;
+	while ((child = readdir(d)) != NULL) {
+		std::string name = child->d_name;
+		if (name == "." || name == "..")
+			continue;
+		if (!collect(path + "/" + name, entries))
+			success = false;
+	}
+
+	closedir(d);
+	return success;
+}
+
+/* sorts entries by name so packs build the same way every time */
+bool byName(const Entry& a, const Entry& b)
+{
+	return a.name < b.name;
+}
+
+/* copies a file into the pack at the current position */
+bool copyFile(SDL_RWops* pack, Entry& entry)
+{
+	size_t size;
+	void* data = SDL_LoadFile(entry.name.c_str(), &size);
+	if (data == NULL || size != entry.size) {
+		printf("Unable to read %s! SDL Error: %s\n", entry.name.c_str(), SDL_GetError());
+		SDL_free(data);
+		return false;
+	}
+
+	bool success = SDL_RWwrite(pack, data, 1, size) == size;
+	SDL_free(data);
+	return success;
+}
+
+int main(int argc, char* args[])
+{
+	if (argc < 3) {
+		printf("usage: %s <pack file> <directory>...\n", args[0]);
+		return 1;
+	}
+
+	/* find the files */
+	std::vector<Entry> entries;
+	for (int i = 2; i < argc; ++i) {
+		std::string dir = args[i];
+		while (dir.size() > 1 && dir[dir.size() - 1] == '/')
+			dir.erase(dir.size() - 1);
+		if (!collect(dir, entries))
+			return 1;
+	}
+	std::sort(entries.begin(), entries.end(), byName);
+
+	/* lay out the table of contents and the blobs behind it */
+	Uint64 tocSize = 0;
+	for (int n = 0; n < entries.size(); ++n)
+		tocSize += 8 + 8 + 2 + entries[n].name.size();
+
+	Uint64 offset = align(PACK_HEADER_SIZE + tocSize);
+	for (int n = 0; n < entries.size(); ++n) {
+		entries[n].offset = offset;
+		offset = align(offset + entries[n].size);
+	}
+
+	SDL_RWops* pack = SDL_RWFromFile(args[1], "wb");
+	if (pack == NULL) {
+		printf("Unable to create %s! SDL Error: %s\n", args[1], SDL_GetError());
+		return 1;
+	}
+
+	/* write the header and table of contents */
+	SDL_WriteLE32(pack, PACK_MAGIC);
+	SDL_WriteLE32(pack, PACK_VERSION);
+	SDL_WriteLE32(pack, entries.size());
+	SDL_WriteLE32(pack, tocSize);
+	for (int n = 0; n < entries.size(); ++n) {
+		SDL_WriteLE64(pack, entries[n].offset);
+		SDL_WriteLE64(pack, entries[n].size);
+		SDL_WriteLE16(pack, entries[n].name.size());
+		SDL_RWwrite(pack, entries[n].name.c_str(), 1, entries[n].name.size());
+	}
+
+	/* write the blobs, zero padding up to each offset */
+	bool success = true;
+	const Uint8 zeros[PACK_ALIGNMENT] = { 0 };
+	for (int n = 0; n < entries.size() && success; ++n) {
+		Sint64 position = SDL_RWtell(pack);
+		SDL_RWwrite(pack, zeros, 1, entries[n].offset - position);
+		success = copyFile(pack, entries[n]);
+	}
+
+	if (SDL_RWclose(pack) != 0)
+		success = false;
+
+	if (!success) {
+		printf("Failed to write %s!\n", args[1]);
+		remove(args[1]);
+		return 1;
+	}
+
+	printf("Packed %d files into %s\n", (int)entries.size(), args[1]);
+	return 0;
+}
@@ -0,0 +1,306 @@
+/*
+ * atlaspack - merges a directory of images into one texture atlas
+ *
+ * usage: atlaspack [-w width] [-p padding] <image directory> <atlas.png> <atlas index>
+ *
+ * The images are packed with a skyline bottom-left packer. The index is a
+ * little endian binary file read by LTextureAtlas:
+ *
+ *   Uint32 magic ("LTAT"), Uint32 version, Uint32 clip count
+ *   per clip: Uint8 name length, name bytes, Uint16 x, y, w, h
+ *
+ * Clip names are the image file names without their extension.
+ */
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+/* index file identification */
+const Uint32 ATLAS_MAGIC = 0x5441544C;
+const Uint32 ATLAS_VERSION = 1;
+
+/* an image waiting to be placed in the atlas */
+struct Image
+{
+	std::string name;
+	SDL_Surface* surface;
+	SDL_Rect clip;
+};
+
+/* a horizontal segment of the packed skyline */
+struct SkylineNode
+{
+	int x, y, w;
+};
+
+/*
+ * larger images first gives the packer the fewest holes, images of the same
+ * size go by name so the atlas doesn't depend on the directory's order
+ */
+bool tallerFirst(const Image& a, const Image& b)
+{
+	if (a.surface->h != b.surface->h)
+		return a.surface->h > b.surface->h;
+	if (a.surface->w != b.surface->w)
+		return a.surface->w > b.surface->w;
+	return a.name < b.name;
+}
+
+/* the lowest y a w wide rectangle can rest at starting on node i, or -1 */
+int skylineFit(std::vector<SkylineNode>& skyline, int i, int w, int atlasWidth)
+{
+	int x = skyline[i].x;
+	if (x + w > atlasWidth)
+		return -1;
+
+	int y = 0;
+	int remaining = w;
+	while (remaining > 0) {
+		if (skyline[i].y > y)
+			y = skyline[i].y;
+		remaining -= skyline[i].w;
+		++i;
+	}
+
+	return y;
+}
+
+/* raises the skyline under a newly placed rectangle */
+void skylineAdd(std::vector<SkylineNode>& skyline, int i, SDL_Rect& r)
+{
+	SkylineNode node = { r.x, r.y + r.h, r.w };
+	skyline.insert(skyline.begin() + i, node);
+
+	/* trim the nodes now covered by the new one */
+	for (int j = i + 1; j < skyline.size(); ) {
+		int overlap = skyline[j - 1].x + skyline[j - 1].w - skyline[j].x;
+		if (overlap <= 0)
+			break;
+
+		if (overlap >= skyline[j].w) {
+			skyline.erase(skyline.begin() + j);
+		}
+		else {
+			skyline[j].x += overlap;
+			skyline[j].w -= overlap;
+			break;
+		}
+	}
+
+	/* merge neighbours at the same height */
+	for (int j = 0; j + 1 < skyline.size(); ) {
+		if (skyline[j].y == skyline[j + 1].y) {
+			skyline[j].w += skyline[j + 1].w;
+			skyline.erase(skyline.begin() + j + 1);
+		}
+		else {
+			++j;
+		}
+	}
+}
+
+/* places every image, returns the used atlas height or -1 if one doesn't fit */
+int pack(std::vector<Image>& images, int atlasWidth, int padding)
+{
+	std::vector<SkylineNode> skyline;
+	SkylineNode start = { 0, 0, atlasWidth };
+	skyline.push_back(start);
+
+	int height = 0;
+	for (int n = 0; n < images.size(); ++n) {
+		int w = images[n].surface->w + padding;
+		int h = images[n].surface->h + padding;
+
+		/* pick the position with the lowest top edge, then the narrowest node */
+		int bestNode = -1, bestY = 0, bestWidth = 0;
+		for (int i = 0; i < skyline.size(); ++i) {
+			int y = skylineFit(skyline, i, w, atlasWidth);
+			if (y < 0)
+				continue;
+			if (bestNode < 0 || y < bestY || (y == bestY && skyline[i].w < bestWidth)) {
+				bestNode = i;
+				bestY = y;
+				bestWidth = skyline[i].w;
+			}
+		}
+
+		if (bestNode < 0) {
+			printf("%s is wider than the atlas!\n", images[n].name.c_str());
+			return -1;
+		}
+
+		SDL_Rect r = { skyline[bestNode].x, bestY, w, h };
+		skylineAdd(skyline, bestNode, r);
+
+		images[n].clip.x = r.x;
+		images[n].clip.y = r.y;
+		images[n].clip.w = images[n].surface->w;
+		images[n].clip.h = images[n].surface->h;
+
+		if (r.y + h > height)
+			height = r.y + h;
+	}
+
+	return height;
+}
+
+/* loads every image in the directory */
+bool loadImages(std::string dir, std::vector<Image>& images)
+{
+	DIR* d = opendir(dir.c_str());
+	if (d == NULL) {
+		printf("Unable to open directory %s!\n", dir.c_str());
+		return false;
+	}
+
+	bool success = true;
+	struct dirent* entry;
+	while ((entry = readdir(d)) != NULL) {
+		std::string file = entry->d_name;
+		size_t dot = file.rfind('.');
+		if (file[0] == '.' || dot == std::string::npos)
+			continue;
+
+		std::string path = dir + "/" + file;
+		SDL_Surface* loaded = IMG_Load(path.c_str());
+		if (loaded == NULL) {
+			printf("Unable to load image %s! SDL_image Error: %s\n", path.c_str(), IMG_GetError());
+			success = false;
+			continue;
+		}
+
+		/* one pixel format lets every image copy into the atlas unchanged */
+		SDL_Surface* converted = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888, 0);
+		SDL_FreeSurface(loaded);
+		if (converted == NULL) {
+			printf("Unable to convert image %s! SDL Error: %s\n", path.c_str(), SDL_GetError());
+			success = false;
+			continue;
+		}
+
+		if (dot > 255) {
+			printf("Image name %s is too long!\n", file.c_str());
+			SDL_FreeSurface(converted);
+			success = false;
+			continue;
+		}
+
+		Image image;
+		image.name = file.substr(0, dot);
+		image.surface = converted;
+		images.push_back(image);
+	}
+
+	closedir(d);
+	return success;
+}
+
+/* writes the clip index */
+bool writeIndex(std::string path, std::vector<Image>& images)
+{
+	SDL_RWops* file = SDL_RWFromFile(path.c_str(), "wb");
+	if (file == NULL) {
+		printf("Unable to open %s! SDL Error: %s\n", path.c_str(), SDL_GetError());
+		return false;
+	}
+
+	SDL_WriteLE32(file, ATLAS_MAGIC);
+	SDL_WriteLE32(file, ATLAS_VERSION);
+	SDL_WriteLE32(file, images.size());
+	for (int n = 0; n < images.size(); ++n) {
+		SDL_WriteU8(file, images[n].name.size());
+		SDL_RWwrite(file, images[n].name.c_str(), 1, images[n].name.size());
+		SDL_WriteLE16(file, images[n].clip.x);
+		SDL_WriteLE16(file, images[n].clip.y);
+		SDL_WriteLE16(file, images[n].clip.w);
+		SDL_WriteLE16(file, images[n].clip.h);
+	}
+
+	return SDL_RWclose(file) == 0;
+}
+
+int main(int argc, char* args[])
+{
+	int atlasWidth = 1024;
+	int padding = 1;
+
+	/* read the options */
+	int arg = 1;
+	for (; arg + 1 < argc && args[arg][0] == '-'; arg += 2) {
+		if (strcmp(args[arg], "-w") == 0)
+			atlasWidth = atoi(args[arg + 1]);
+		else if (strcmp(args[arg], "-p") == 0)
+			padding = atoi(args[arg + 1]);
+		else
+			break;
+	}
+
+	if (argc - arg != 3 || atlasWidth <= 0 || padding < 0) {
+		printf("usage: %s [-w width] [-p padding] <image directory> <atlas.png> <atlas index>\n", args[0]);
+		return 1;
+	}
+
+	if (SDL_Init(0) < 0 || !(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
+		printf("SDL could not initialize! SDL Error: %s\n", SDL_GetError());
+		return 1;
+	}
+
+	std::vector<Image> images;
+	bool success = loadImages(args[arg], images) && !images.empty();
+
+	/* pack and compose the atlas */
+	SDL_Surface* atlas = NULL;
+	if (success) {
+		std::sort(images.begin(), images.end(), tallerFirst);
+
+		int height = pack(images, atlasWidth, padding);
+		if (height < 0 || height > 0xFFFF || atlasWidth > 0xFFFF) {
+			printf("Unable to fit the images into the atlas!\n");
+			success = false;
+		}
+		else {
+			atlas = SDL_CreateRGBSurfaceWithFormat(0, atlasWidth, height, 32, SDL_PIXELFORMAT_ARGB8888);
+			if (atlas == NULL) {
+				printf("Unable to create atlas surface! SDL Error: %s\n", SDL_GetError());
+				success = false;
+			}
+		}
+	}
+
+	if (success) {
+		/* fill with the cyan color key so the padding stays transparent */
+		SDL_FillRect(atlas, NULL, SDL_MapRGB(atlas->format, 0, 0xFF, 0xFF));
+		for (int n = 0; n < images.size(); ++n) {
+			SDL_SetSurfaceBlendMode(images[n].surface, SDL_BLENDMODE_NONE);
+			SDL_BlitSurface(images[n].surface, NULL, atlas, &images[n].clip);
+		}
+
+		if (IMG_SavePNG(atlas, args[arg + 1]) < 0) {
+			printf("Unable to save %s! SDL_image Error: %s\n", args[arg + 1], IMG_GetError());
+			success = false;
+		}
+		else if (!writeIndex(args[arg + 2], images)) {
+			success = false;
+		}
+		else {
+			printf("Packed %d images into %dx%d\n", (int)images.size(), atlas->w, atlas->h);
+		}
+	}
+
+	/* free everything */
+	if (atlas != NULL)
+		SDL_FreeSurface(atlas);
+	for (int n = 0; n < images.size(); ++n)
+		SDL_FreeSurface(images[n].surface);
+
+	IMG_Quit();
+	SDL_Quit();
+
+	return success ? 0 : 1;
+}
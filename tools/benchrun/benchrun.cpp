@@ -0,0 +1,217 @@
+/*
+ * benchrun - runs lesson scenes headless and collects their timings
+ *
+ * usage: benchrun [-r repo root] [-n frames] [-d video driver] [-o output]
+ *                 [-i input log] [-t trace prefix] [scene...]
+ *
+ * Each scene is started in its lesson directory with SDL_VIDEODRIVER set to
+ * offscreen (or the -d driver), the software renderer and LESSON_BENCH_FRAMES
+ * and LESSON_BENCH_INPUT set, which switches the lesson's LBenchmark into
+ * headless mode. If a scene reports nothing with the offscreen driver it is
+ * retried with the dummy one, since older SDL builds lack offscreen.
+ *
+ * With -i the scenes replay an input log recorded with LESSON_RECORD_INPUT
+ * instead of their scripts, running as many frames as the log covers unless
+ * -n is given. With -t every scene writes its frame times to
+ * <prefix><scene>.csv, to compare builds frame by frame on the same input.
+ *
+ * The lessons must already be built. Results are written as a JSON array,
+ * one object per scene, to stdout or the -o file; the exit status is non
+ * zero if any scene failed.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+/* a lesson that can run headless */
+struct Scene
+{
+	const char* name;
+	const char* directory;
+	const char* command;
+	const char* input;
+};
+
+/* the benchmarked scenes, input scripts are frame:+Key / frame:-Key */
+const Scene SCENES[] = {
+	{ "animated", "14-animated-sprites-and-vsync", "./animated 2000", "30:+R,31:-R,60:+Z,61:-Z,90:+A,91:-A" },
+	{ "motion", "26-motion", "./motion", "0:+Right,120:-Right,120:+Down,240:-Down,240:+Left,360:-Left,360:+Up,480:-Up" },
+	{ "collision", "27-collision", "./collision", "0:+Right,90:-Right,90:+Down,150:-Down,150:+Right,240:-Right" },
+	{ "mouse", "17-mouse-events", "./mouse", "" },
+};
+const int SCENE_COUNT = sizeof(SCENES) / sizeof(SCENES[0]);
+
+/* quotes a string for the shell */
+std::string quote(std::string text)
+{
+	std::string quoted = "'";
+	for (int i = 0; i < text.size(); ++i) {
+		if (text[i] == '\'')
+			quoted += "'\\''";
+		else
+			quoted += text[i];
+	}
+	return quoted + "'";
+}
+
+/* escapes a string for a JSON value */
+std::string escape(std::string text)
+{
+	std::string escaped;
+	for (int i = 0; i < text.size(); ++i) {
+		if (text[i] == '"' || text[i] == '\\')
+			escaped += '\\';
+		if ((unsigned char)text[i] >= 0x20)
+			escaped += text[i];
+	}
+	return escaped;
+}
+
+/* makes a path usable from inside a lesson directory */
+std::string absolute(std::string path)
+{
+	if (path.empty() || path[0] == '/')
+		return path;
+
+	char directory[4096];
+	if (getcwd(directory, sizeof(directory)) == NULL)
+		return path;
+	return std::string(directory) + "/" + path;
+}
+
+/* runs a scene with a video driver, returning its JSON report or an empty string; frames 0 runs a replay to its end */
+std::string runScene(std::string root, const Scene& scene, int frames, std::string driver, std::string replay, std::string trace, std::string& output)
+{
+	char frameText[32];
+	snprintf(frameText, sizeof(frameText), "%d", frames);
+
+	std::string command = "(cd " + quote(root + "/" + scene.directory) +
+		" && SDL_VIDEODRIVER=" + quote(driver) +
+		" SDL_RENDER_DRIVER=software";
+	if (frames > 0)
+		command += " LESSON_BENCH_FRAMES=" + std::string(frameText);
+	if (replay.empty())
+		command += " LESSON_BENCH_INPUT=" + quote(scene.input);
+	else
+		command += " LESSON_BENCH_REPLAY=" + quote(replay);
+	if (!trace.empty())
+		command += " LESSON_BENCH_TRACE=" + quote(trace + scene.name + ".csv");
+	command += " " + std::string(scene.command) + ") 2>&1";
+
+	FILE* pipe = popen(command.c_str(), "r");
+	if (pipe == NULL)
+		return "";
+
+	/* the report is the line starting with the scene object */
+	std::string report;
+	char line[4096];
+	output.clear();
+	while (fgets(line, sizeof(line), pipe) != NULL) {
+		if (strncmp(line, "{\"scene\":", 9) == 0) {
+			report = line;
+			while (!report.empty() && (report[report.size() - 1] == '\n' || report[report.size() - 1] == '\r'))
+				report.erase(report.size() - 1);
+		} else {
+			output += line;
+		}
+	}
+
+	if (pclose(pipe) != 0)
+		return "";
+	return report;
+}
+
+int main(int argc, char* args[])
+{
+	std::string root = ".";
+	std::string driver = "offscreen";
+	std::string outputPath;
+	std::string replay;
+	std::string trace;
+	int frames = 600;
+	bool framesGiven = false;
+	std::vector<const Scene*> scenes;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = args[i];
+		if (arg == "-r" && i + 1 < argc) {
+			root = args[++i];
+		} else if (arg == "-n" && i + 1 < argc) {
+			frames = atoi(args[++i]);
+			framesGiven = true;
+		} else if (arg == "-d" && i + 1 < argc) {
+			driver = args[++i];
+		} else if (arg == "-o" && i + 1 < argc) {
+			outputPath = args[++i];
+		} else if (arg == "-i" && i + 1 < argc) {
+			replay = absolute(args[++i]);
+		} else if (arg == "-t" && i + 1 < argc) {
+			trace = absolute(args[++i]);
+		} else {
+			const Scene* found = NULL;
+			for (int n = 0; n < SCENE_COUNT; ++n) {
+				if (arg == SCENES[n].name)
+					found = &SCENES[n];
+			}
+			if (found == NULL) {
+				printf("usage: %s [-r repo root] [-n frames] [-d video driver] [-o output] [-i input log] [-t trace prefix] [scene...]\n", args[0]);
+				printf("scenes:");
+				for (int n = 0; n < SCENE_COUNT; ++n)
+					printf(" %s", SCENES[n].name);
+				printf("\n");
+				return 1;
+			}
+			scenes.push_back(found);
+		}
+	}
+
+	if (frames <= 0) {
+		printf("Frame count must be positive!\n");
+		return 1;
+	}
+
+	/* a replay runs to the end of its log unless told otherwise */
+	if (!replay.empty() && !framesGiven)
+		frames = 0;
+
+	if (scenes.empty()) {
+		for (int n = 0; n < SCENE_COUNT; ++n)
+			scenes.push_back(&SCENES[n]);
+	}
+
+	FILE* out = stdout;
+	if (!outputPath.empty()) {
+		out = fopen(outputPath.c_str(), "w");
+		if (out == NULL) {
+			printf("Unable to write %s!\n", outputPath.c_str());
+			return 1;
+		}
+	}
+
+	/* run every scene, falling back to the dummy driver */
+	bool success = true;
+	fprintf(out, "[\n");
+	for (int n = 0; n < scenes.size(); ++n) {
+		std::string output;
+		std::string report = runScene(root, *scenes[n], frames, driver, replay, trace, output);
+		if (report.empty() && driver == "offscreen")
+			report = runScene(root, *scenes[n], frames, "dummy", replay, trace, output);
+
+		if (report.empty()) {
+			fprintf(stderr, "%s failed:\n%s", scenes[n]->name, output.c_str());
+			report = "{\"scene\":\"" + std::string(scenes[n]->name) + "\",\"error\":\"" + escape(output) + "\"}";
+			success = false;
+		}
+
+		fprintf(out, "  %s%s\n", report.c_str(), n + 1 < scenes.size() ? "," : "");
+	}
+	fprintf(out, "]\n");
+
+	if (out != stdout)
+		fclose(out);
+
+	return success ? 0 : 1;
+}